@@ -0,0 +1,109 @@
+#include "caching_unit_of_work.h"
+
+namespace app {
+
+std::optional<std::string> AuthorCache::FindName(const domain::AuthorId& author_id) {
+    auto name = names_.Get(author_id);
+    (name.has_value() ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return name;
+}
+
+std::optional<domain::AuthorId> AuthorCache::FindId(const std::string& name) {
+    auto author_id = ids_.Get(name);
+    (author_id.has_value() ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return author_id;
+}
+
+bool AuthorCache::Put(const domain::AuthorId& author_id, const std::string& name, uint64_t generation) {
+    std::shared_lock lock{generation_mutex_};
+    if (generation != generation_.load(std::memory_order_relaxed))
+        return false;
+    names_.Put(author_id, name);
+    ids_.Put(name, author_id);
+    return true;
+}
+
+void AuthorCache::Invalidate(const domain::AuthorId& author_id) {
+    std::unique_lock lock{generation_mutex_};
+    generation_.fetch_add(1, std::memory_order_release);
+    names_.Erase(author_id);
+    // The old name may have been evicted from names_ while still cached in ids_
+    ids_.EraseIf([&author_id](const std::string&, const domain::AuthorId& cached_id) {
+        return cached_id == author_id;
+    });
+}
+
+void AuthorCache::InvalidateName(const std::string& name) {
+    std::unique_lock lock{generation_mutex_};
+    generation_.fetch_add(1, std::memory_order_release);
+    ids_.Erase(name);
+}
+
+std::optional<domain::AuthorId> CachingUnitOfWork::AddAuthor(const std::string& name) {
+    auto author_id = inner_->AddAuthor(name);
+    changed_names_.push_back(name);
+    return author_id;
+}
+
+std::optional<items::AuthorInfo> CachingUnitOfWork::FindAuthorByName(const std::string& author_name) {
+    if (HasAuthorChanges())
+        return inner_->FindAuthorByName(author_name);
+    if (auto author_id = cache_.FindId(author_name))
+        return items::AuthorInfo{*author_id, std::string{author_name}};
+    auto author = inner_->FindAuthorByName(author_name);
+    if (author.has_value())
+        FillCache(*author);
+    return author;
+}
+
+std::optional<items::AuthorInfo> CachingUnitOfWork::FindAuthorById(const domain::AuthorId& author_id) {
+    if (HasAuthorChanges())
+        return inner_->FindAuthorById(author_id);
+    if (auto name = cache_.FindName(author_id))
+        return items::AuthorInfo{author_id, std::move(*name)};
+    auto author = inner_->FindAuthorById(author_id);
+    if (author.has_value())
+        FillCache(*author);
+    return author;
+}
+
+std::optional<items::AuthorInfo> CachingUnitOfWork::GetBookAuthor(const domain::BookId& book_id) {
+    auto author = inner_->GetBookAuthor(book_id);
+    if (author.has_value() && !HasAuthorChanges())
+        FillCache(*author);
+    return author;
+}
+
+void CachingUnitOfWork::FillCache(const items::AuthorInfo& author) {
+    if (fills_cache_)
+        cache_.Put(author.id, author.name, generation_);
+}
+
+void CachingUnitOfWork::DeleteAuthor(const domain::AuthorId& author_id) {
+    inner_->DeleteAuthor(author_id);
+    changed_ids_.push_back(author_id);
+}
+
+void CachingUnitOfWork::EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) {
+    inner_->EditAuthor(author_id, new_author_name);
+    changed_ids_.push_back(author_id);
+    changed_names_.push_back(new_author_name);
+}
+
+void CachingUnitOfWork::Commit() {
+    inner_->Commit();
+    for (const auto& author_id: changed_ids_)
+        cache_.Invalidate(author_id);
+    for (const auto& name: changed_names_)
+        cache_.InvalidateName(name);
+    changed_ids_.clear();
+    changed_names_.clear();
+}
+
+void CachingUnitOfWork::Reset() {
+    inner_->Reset();
+    changed_ids_.clear();
+    changed_names_.clear();
+}
+
+}  // namespace app
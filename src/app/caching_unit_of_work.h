@@ -0,0 +1,92 @@
+#pragma once
+#include <boost/uuid/uuid_hash.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "../util/lru_cache.h"
+#include "forwarding_unit_of_work.h"
+
+namespace app {
+
+// Committed author names by id and ids by name, shared by all units of work. Every invalidation
+// starts a new generation; values read before it may be stale and are not stored.
+class AuthorCache {
+public:
+    explicit AuthorCache(size_t capacity, size_t shard_count = 16)
+        : names_{capacity, shard_count}
+        , ids_{capacity, shard_count} {
+    }
+
+    std::optional<std::string> FindName(const domain::AuthorId& author_id);
+    std::optional<domain::AuthorId> FindId(const std::string& name);
+    uint64_t GetGeneration() const noexcept {
+        return generation_.load(std::memory_order_acquire);
+    }
+    // Stores an author read during the given generation; false when it has ended since
+    bool Put(const domain::AuthorId& author_id, const std::string& name, uint64_t generation);
+    // Forgets the author under its id and under any name it was cached with
+    void Invalidate(const domain::AuthorId& author_id);
+    void InvalidateName(const std::string& name);
+
+    size_t GetHits() const noexcept {
+        return hits_.load(std::memory_order_relaxed);
+    }
+    size_t GetMisses() const noexcept {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+private:
+    util::ShardedLruCache<domain::AuthorId, std::string, util::TaggedHasher<domain::AuthorId>> names_;
+    util::ShardedLruCache<std::string, domain::AuthorId> ids_;
+    // Puts check the generation under a shared lock, invalidations advance it exclusively
+    std::shared_mutex generation_mutex_;
+    std::atomic<uint64_t> generation_ = 0;
+    std::atomic<size_t> hits_ = 0;
+    std::atomic<size_t> misses_ = 0;
+};
+
+// Serves FindAuthorById, FindAuthorByName and GetBookAuthor results from an AuthorCache.
+// Author changes made through the unit invalidate the cache when it commits and are forgotten
+// on Reset; until then the unit bypasses the cache so it sees its own uncommitted changes.
+// Authors the unit reads fill the cache unless an invalidation happened since the unit began
+// or they come from a replica, which may still return rows the primary has changed.
+class CachingUnitOfWork : public ForwardingUnitOfWork {
+public:
+    CachingUnitOfWork(std::unique_ptr<UnitOfWork> inner, AuthorCache& cache,
+                      ReadSource source = ReadSource::Primary)
+        : ForwardingUnitOfWork{std::move(inner)}
+        , cache_{cache}
+        , fills_cache_{source == ReadSource::Primary}
+        , generation_{cache.GetGeneration()} {
+    }
+
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override;
+    std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) override;
+    void DeleteAuthor(const domain::AuthorId& author_id) override;
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override;
+    std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) override;
+    std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) override;
+    void Commit() override;
+    void Reset() override;
+
+private:
+    bool HasAuthorChanges() const noexcept {
+        return !changed_ids_.empty() || !changed_names_.empty();
+    }
+    void FillCache(const items::AuthorInfo& author);
+
+    AuthorCache& cache_;
+    bool fills_cache_;
+    // Cache generation when the unit began, before any of its queries
+    uint64_t generation_;
+    std::vector<domain::AuthorId> changed_ids_;
+    std::vector<std::string> changed_names_;
+};
+
+}  // namespace app
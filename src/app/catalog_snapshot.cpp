@@ -0,0 +1,239 @@
+#include "catalog_snapshot.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "listing_order.h"
+
+namespace app {
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshot::Load(UnitOfWork& unit_of_work) {
+    std::shared_ptr<CatalogSnapshot> snapshot{new CatalogSnapshot};
+    auto& catalog = *snapshot;
+
+    for (const auto& author: unit_of_work.GetAuthors())
+        catalog.AddAuthor(author.id, author.name);
+
+    unit_of_work.ForEachBook([&catalog](const items::BookInfo& book) {
+        auto [it, inserted] = catalog.book_ordinals_.try_emplace(book.id, static_cast<Ordinal>(catalog.book_ids_.size()));
+        if (!inserted)
+            return;
+        catalog.book_ids_.push_back(book.id);
+        catalog.book_titles_.push_back(catalog.Intern(book.title));
+        catalog.book_years_.push_back(book.publication_year);
+        // Authors added after GetAuthors ran are picked up from the book rows
+        catalog.book_authors_.push_back(catalog.AddAuthor(book.author_id, book.author_name));
+    });
+
+    std::unordered_map<std::string, Ordinal> tag_ids;
+    std::vector<std::pair<Ordinal, Ordinal>> book_tags;
+    unit_of_work.ForEachBookTag([&catalog, &tag_ids, &book_tags](const domain::BookId& book_id, std::string&& tag) {
+        auto book = catalog.book_ordinals_.find(book_id);
+        if (book == catalog.book_ordinals_.end())
+            return;
+        auto [it, inserted] = tag_ids.try_emplace(std::move(tag), static_cast<Ordinal>(catalog.tag_names_.size()));
+        if (inserted)
+            catalog.tag_names_.push_back(catalog.Intern(it->first));
+        book_tags.emplace_back(book->second, it->second);
+    });
+
+    catalog.BuildIndexes(std::move(book_tags));
+    return snapshot;
+}
+
+CatalogSnapshot::StringRef CatalogSnapshot::Intern(std::string_view text) {
+    if (arena_.size() + text.size() > std::numeric_limits<uint32_t>::max())
+        throw std::length_error("Catalog text does not fit in a snapshot");
+    StringRef ref{static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(text.size())};
+    arena_.append(text);
+    return ref;
+}
+
+CatalogSnapshot::Ordinal CatalogSnapshot::AddAuthor(const domain::AuthorId& author_id, std::string_view name) {
+    auto [it, inserted] = author_ordinals_.try_emplace(author_id, static_cast<Ordinal>(author_ids_.size()));
+    if (inserted) {
+        author_ids_.push_back(author_id);
+        author_names_.push_back(Intern(name));
+    }
+    return it->second;
+}
+
+void CatalogSnapshot::BuildIndexes(std::vector<std::pair<Ordinal, Ordinal>>&& book_tags) {
+    const auto book_count = static_cast<Ordinal>(book_ids_.size());
+
+    BookSortKeys sort_keys{book_count};
+    for (Ordinal book = 0; book < book_count; ++book)
+        sort_keys.Add(View(book_titles_[book]), View(author_names_[book_authors_[book]]));
+    books_by_title_ = sort_keys.SortedPermutation();
+
+    // Counting sort by author, then each author's books by year
+    author_book_offsets_.assign(author_ids_.size() + 1, 0);
+    for (auto author: book_authors_)
+        ++author_book_offsets_[author + 1];
+    std::partial_sum(author_book_offsets_.begin(), author_book_offsets_.end(), author_book_offsets_.begin());
+    books_by_author_.resize(book_count);
+    std::vector<uint32_t> cursors(author_book_offsets_.begin(), author_book_offsets_.end() - 1);
+    for (Ordinal book = 0; book < book_count; ++book)
+        books_by_author_[cursors[book_authors_[book]]++] = book;
+    for (size_t author = 0; author < author_ids_.size(); ++author) {
+        std::sort(books_by_author_.begin() + author_book_offsets_[author],
+                  books_by_author_.begin() + author_book_offsets_[author + 1], [this](Ordinal l, Ordinal r) {
+                      if (book_years_[l] != book_years_[r])
+                          return book_years_[l] < book_years_[r];
+                      return View(book_titles_[l]) < View(book_titles_[r]);
+                  });
+    }
+
+    // Counting sort by book, keeping each book's tags in the order they were read
+    book_tag_offsets_.assign(book_count + 1, 0);
+    for (const auto& [book, tag]: book_tags)
+        ++book_tag_offsets_[book + 1];
+    std::partial_sum(book_tag_offsets_.begin(), book_tag_offsets_.end(), book_tag_offsets_.begin());
+    book_tags_.resize(book_tags.size());
+    cursors.assign(book_tag_offsets_.begin(), book_tag_offsets_.end() - 1);
+    for (const auto& [book, tag]: book_tags)
+        book_tags_[cursors[book]++] = tag;
+}
+
+items::BookInfo CatalogSnapshot::MakeBook(Ordinal book) const {
+    auto author = book_authors_[book];
+    return {std::string{View(book_titles_[book])}, book_ids_[book], author_ids_[author],
+            std::string{View(author_names_[author])}, book_years_[book]};
+}
+
+std::vector<items::BookInfo> CatalogSnapshot::GetBooks() const {
+    std::vector<items::BookInfo> books;
+    books.reserve(books_by_title_.size());
+    for (auto book: books_by_title_)
+        books.push_back(MakeBook(book));
+    return books;
+}
+
+void CatalogSnapshot::ForEachBook(const BookVisitor& visitor) const {
+    for (auto book: books_by_title_)
+        visitor(MakeBook(book));
+}
+
+std::vector<items::BookInfo> CatalogSnapshot::GetAuthorBooks(const domain::AuthorId& author_id) const {
+    auto author = author_ordinals_.find(author_id);
+    if (author == author_ordinals_.end())
+        return {};
+    auto first = books_by_author_.begin() + author_book_offsets_[author->second];
+    auto last = books_by_author_.begin() + author_book_offsets_[author->second + 1];
+    std::vector<items::BookInfo> books;
+    books.reserve(last - first);
+    for (auto it = first; it != last; ++it)
+        books.push_back(MakeBook(*it));
+    return books;
+}
+
+std::vector<items::BookInfo> CatalogSnapshot::FindBookByTitle(const std::string& book_title) const {
+    auto matches = std::ranges::equal_range(books_by_title_, std::string_view{book_title}, {}, [this](Ordinal book) {
+        return View(book_titles_[book]);
+    });
+    std::vector<items::BookInfo> books;
+    books.reserve(matches.size());
+    for (auto book: matches)
+        books.push_back(MakeBook(book));
+    return books;
+}
+
+std::vector<std::string> CatalogSnapshot::GetBookTags(const domain::BookId& book_id) const {
+    auto book = book_ordinals_.find(book_id);
+    if (book == book_ordinals_.end())
+        return {};
+    std::vector<std::string> tags;
+    tags.reserve(book_tag_offsets_[book->second + 1] - book_tag_offsets_[book->second]);
+    for (auto i = book_tag_offsets_[book->second]; i < book_tag_offsets_[book->second + 1]; ++i)
+        tags.emplace_back(View(tag_names_[book_tags_[i]]));
+    return tags;
+}
+
+uint64_t CatalogSnapshotStore::GetGeneration() const {
+    std::lock_guard lock{mutex_};
+    return generation_;
+}
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshotStore::Get(UnitOfWork& unit_of_work, uint64_t generation) {
+    {
+        std::lock_guard lock{mutex_};
+        if (snapshot_)
+            return snapshot_;
+    }
+    std::lock_guard load_lock{load_mutex_};
+    {
+        std::lock_guard lock{mutex_};
+        if (snapshot_)
+            return snapshot_;
+    }
+    auto snapshot = CatalogSnapshot::Load(unit_of_work);
+    std::lock_guard lock{mutex_};
+    if (generation_ == generation)
+        snapshot_ = snapshot;
+    return snapshot;
+}
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshotStore::Find() const {
+    std::lock_guard lock{mutex_};
+    return snapshot_;
+}
+
+void CatalogSnapshotStore::Invalidate() {
+    std::lock_guard lock{mutex_};
+    snapshot_.reset();
+    ++generation_;
+}
+
+std::shared_ptr<const CatalogSnapshot> SnapshotUnitOfWork::GetSnapshot() {
+    if (has_changes_)
+        return nullptr;
+    if (!snapshot_)
+        snapshot_ = loading_ == SnapshotLoading::Load ? store_.Get(*inner_, generation_) : store_.Find();
+    return snapshot_;
+}
+
+std::vector<items::BookInfo> SnapshotUnitOfWork::GetBooks() {
+    if (auto snapshot = GetSnapshot())
+        return snapshot->GetBooks();
+    return inner_->GetBooks();
+}
+
+void SnapshotUnitOfWork::ForEachBook(const BookVisitor& visitor) {
+    if (auto snapshot = GetSnapshot())
+        return snapshot->ForEachBook(visitor);
+    inner_->ForEachBook(visitor);
+}
+
+std::vector<items::BookInfo> SnapshotUnitOfWork::GetAuthorBooks(const domain::AuthorId& author_id) {
+    if (auto snapshot = GetSnapshot())
+        return snapshot->GetAuthorBooks(author_id);
+    return inner_->GetAuthorBooks(author_id);
+}
+
+std::vector<items::BookInfo> SnapshotUnitOfWork::FindBookByTitle(const std::string& book_title) {
+    if (auto snapshot = GetSnapshot())
+        return snapshot->FindBookByTitle(book_title);
+    return inner_->FindBookByTitle(book_title);
+}
+
+std::vector<std::string> SnapshotUnitOfWork::GetBookTags(const domain::BookId& book_id) {
+    if (auto snapshot = GetSnapshot())
+        return snapshot->GetBookTags(book_id);
+    return inner_->GetBookTags(book_id);
+}
+
+void SnapshotUnitOfWork::Commit() {
+    inner_->Commit();
+    if (has_changes_)
+        store_.Invalidate();
+    has_changes_ = false;
+}
+
+void SnapshotUnitOfWork::Reset() {
+    inner_->Reset();
+    has_changes_ = false;
+}
+
+}  // namespace app
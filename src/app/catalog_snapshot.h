@@ -0,0 +1,180 @@
+#pragma once
+#include <boost/uuid/uuid_hash.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "forwarding_unit_of_work.h"
+
+namespace app {
+
+// Immutable in-memory copy of the whole catalog in a columnar layout: one arena for all titles,
+// author names and tag names, and parallel arrays indexed by dense book and author ordinals.
+// Listing orders are precomputed as permutations of book ordinals, so reads only copy rows out.
+class CatalogSnapshot {
+public:
+    // Reads authors, books and tags through the unit of work
+    static std::shared_ptr<const CatalogSnapshot> Load(UnitOfWork& unit_of_work);
+
+    // Sorted by title and case-folded author name, like UnitOfWork::ForEachBook
+    std::vector<items::BookInfo> GetBooks() const;
+    void ForEachBook(const BookVisitor& visitor) const;
+    // Sorted by publication year
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) const;
+    std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) const;
+    std::vector<std::string> GetBookTags(const domain::BookId& book_id) const;
+
+    size_t BookCount() const noexcept {
+        return book_ids_.size();
+    }
+    size_t AuthorCount() const noexcept {
+        return author_ids_.size();
+    }
+
+private:
+    using Ordinal = uint32_t;
+
+    // Location of a string in the arena
+    struct StringRef {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    CatalogSnapshot() = default;
+
+    StringRef Intern(std::string_view text);
+    std::string_view View(StringRef ref) const noexcept {
+        return {arena_.data() + ref.offset, ref.size};
+    }
+    Ordinal AddAuthor(const domain::AuthorId& author_id, std::string_view name);
+    void BuildIndexes(std::vector<std::pair<Ordinal, Ordinal>>&& book_tags);
+    items::BookInfo MakeBook(Ordinal book) const;
+
+    std::string arena_;
+
+    std::vector<domain::AuthorId> author_ids_;
+    std::vector<StringRef> author_names_;
+    std::unordered_map<domain::AuthorId, Ordinal, util::TaggedHasher<domain::AuthorId>> author_ordinals_;
+
+    std::vector<domain::BookId> book_ids_;
+    std::vector<StringRef> book_titles_;
+    std::vector<int32_t> book_years_;
+    std::vector<Ordinal> book_authors_;
+    std::unordered_map<domain::BookId, Ordinal, util::TaggedHasher<domain::BookId>> book_ordinals_;
+
+    // Book ordinals by title, then by case-folded author name
+    std::vector<Ordinal> books_by_title_;
+    // Book ordinals grouped by author and sorted by year; author a owns
+    // books_by_author_[author_book_offsets_[a], author_book_offsets_[a + 1])
+    std::vector<Ordinal> books_by_author_;
+    std::vector<uint32_t> author_book_offsets_;
+    // Tag ids of book b are book_tags_[book_tag_offsets_[b], book_tag_offsets_[b + 1])
+    std::vector<Ordinal> book_tags_;
+    std::vector<uint32_t> book_tag_offsets_;
+    std::vector<StringRef> tag_names_;
+};
+
+// Current snapshot shared by all units of work. It is dropped when a unit of work that changed
+// the catalog commits and rebuilt on the next read. Only changes made through this process
+// invalidate it.
+class CatalogSnapshotStore {
+public:
+    // Incremented by every invalidation
+    uint64_t GetGeneration() const;
+    // Returns the current snapshot, loading one through the unit of work when there is none.
+    // The loaded snapshot is kept only if nothing was invalidated since generation was read,
+    // i.e. the unit of work's transaction saw every commit the store knows of.
+    std::shared_ptr<const CatalogSnapshot> Get(UnitOfWork& unit_of_work, uint64_t generation);
+    // The current snapshot without loading one; null when there is none
+    std::shared_ptr<const CatalogSnapshot> Find() const;
+    void Invalidate();
+
+private:
+    mutable std::mutex mutex_;
+    // Serializes loads so concurrent readers do not all scan the catalog
+    std::mutex load_mutex_;
+    std::shared_ptr<const CatalogSnapshot> snapshot_;
+    uint64_t generation_ = 0;
+};
+
+enum class SnapshotLoading {
+    // Loads a snapshot through the unit of work when the store has none
+    Load,
+    // Reads through to the database when the store has no snapshot
+    UseCurrent,
+};
+
+// Serves GetBooks, ForEachBook, GetAuthorBooks, FindBookByTitle and GetBookTags from the
+// store's snapshot. Once the unit changes anything it reads through to the database so it sees
+// its own changes, and its commit invalidates the snapshot.
+// Replica units never load a snapshot: the replica may not have applied the commit that began
+// the current generation, and the store would keep what they read until the next invalidation.
+class SnapshotUnitOfWork : public ForwardingUnitOfWork {
+public:
+    SnapshotUnitOfWork(std::unique_ptr<UnitOfWork> inner, CatalogSnapshotStore& store,
+                       SnapshotLoading loading = SnapshotLoading::Load, ReadSource source = ReadSource::Primary)
+        : ForwardingUnitOfWork{std::move(inner)}
+        , store_{store}
+        , loading_{source == ReadSource::Primary ? loading : SnapshotLoading::UseCurrent}
+        , generation_{store.GetGeneration()} {
+    }
+
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override {
+        has_changes_ = true;
+        return inner_->AddAuthor(name);
+    }
+    std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) override {
+        has_changes_ = true;
+        return inner_->AddBook(title, year, author_id);
+    }
+    void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) override {
+        has_changes_ = true;
+        inner_->AddBookTags(book_id, book_tags);
+    }
+    std::vector<items::BookInfo> GetBooks() override;
+    void ForEachBook(const BookVisitor& visitor) override;
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) override;
+    std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) override;
+    void DeleteAuthor(const domain::AuthorId& author_id) override {
+        has_changes_ = true;
+        inner_->DeleteAuthor(author_id);
+    }
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override {
+        has_changes_ = true;
+        inner_->EditAuthor(author_id, new_author_name);
+    }
+    void DeleteBook(const domain::BookId& book_id) override {
+        has_changes_ = true;
+        inner_->DeleteBook(book_id);
+    }
+    void EditBook(const items::BookInfo& book) override {
+        has_changes_ = true;
+        inner_->EditBook(book);
+    }
+    std::vector<std::string> GetBookTags(const domain::BookId& book_id) override;
+    void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags) override {
+        has_changes_ = true;
+        inner_->EditBookTags(book_id, new_tags);
+    }
+    void Commit() override;
+    void Reset() override;
+
+private:
+    // Null while the unit has uncommitted changes
+    std::shared_ptr<const CatalogSnapshot> GetSnapshot();
+
+    CatalogSnapshotStore& store_;
+    SnapshotLoading loading_;
+    // Kept for the lifetime of the unit so its reads agree with each other
+    std::shared_ptr<const CatalogSnapshot> snapshot_;
+    // Store generation when the inner unit's transaction began
+    uint64_t generation_;
+    bool has_changes_ = false;
+};
+
+}  // namespace app
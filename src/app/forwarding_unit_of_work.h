@@ -0,0 +1,95 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "use_cases.h"
+
+namespace app {
+
+// Base of unit-of-work decorators: every call goes to the wrapped unit unless overridden
+class ForwardingUnitOfWork : public UnitOfWork {
+public:
+    explicit ForwardingUnitOfWork(std::unique_ptr<UnitOfWork> inner)
+        : inner_{std::move(inner)} {
+    }
+
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override {
+        return inner_->AddAuthor(name);
+    }
+    std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) override {
+        return inner_->AddBook(title, year, author_id);
+    }
+    void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) override {
+        inner_->AddBookTags(book_id, book_tags);
+    }
+    std::vector<items::AuthorInfo> GetAuthors() override {
+        return inner_->GetAuthors();
+    }
+    std::vector<items::BookInfo> GetBooks() override {
+        return inner_->GetBooks();
+    }
+    void ForEachBook(const BookVisitor& visitor) override {
+        inner_->ForEachBook(visitor);
+    }
+    items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit) override {
+        return inner_->GetAuthorsPage(after, limit);
+    }
+    items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) override {
+        return inner_->GetBooksPage(after, limit);
+    }
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) override {
+        return inner_->GetAuthorBooks(author_id);
+    }
+    std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) override {
+        return inner_->FindAuthorByName(author_name);
+    }
+    std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) override {
+        return inner_->FindBookByTitle(book_title);
+    }
+    std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string& book_title) override {
+        return inner_->FindBookDetailsByTitle(book_title);
+    }
+    std::vector<items::BookInfo> SearchBooks(const std::string& query, size_t limit) override {
+        return inner_->SearchBooks(query, limit);
+    }
+    void ForEachBookTag(const BookTagVisitor& visitor) override {
+        inner_->ForEachBookTag(visitor);
+    }
+    void DeleteAuthor(const domain::AuthorId& author_id) override {
+        inner_->DeleteAuthor(author_id);
+    }
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override {
+        inner_->EditAuthor(author_id, new_author_name);
+    }
+    void DeleteBook(const domain::BookId& book_id) override {
+        inner_->DeleteBook(book_id);
+    }
+    void EditBook(const items::BookInfo& book) override {
+        inner_->EditBook(book);
+    }
+    std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) override {
+        return inner_->GetBookAuthor(book_id);
+    }
+    std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) override {
+        return inner_->FindAuthorById(author_id);
+    }
+    std::vector<std::string> GetBookTags(const domain::BookId& book_id) override {
+        return inner_->GetBookTags(book_id);
+    }
+    void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags) override {
+        inner_->EditBookTags(book_id, new_tags);
+    }
+    void Commit() override {
+        inner_->Commit();
+    }
+    void Reset() override {
+        inner_->Reset();
+    }
+
+protected:
+    std::unique_ptr<UnitOfWork> inner_;
+};
+
+}  // namespace app
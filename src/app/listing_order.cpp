@@ -0,0 +1,78 @@
+#include "listing_order.h"
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <limits>
+#include <stdexcept>
+
+namespace app {
+
+namespace {
+
+// A key's first bytes packed big-endian, so comparing prefixes as integers orders them like the bytes
+uint64_t KeyPrefix(std::string_view key) noexcept {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < sizeof(prefix); ++i)
+        prefix = (prefix << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0u);
+    return prefix;
+}
+
+// ASCII case folding as a table, so folding a name is a lookup per byte; multibyte UTF-8 is left as is
+constexpr std::array<char, 256> LOWER_CASE = [] {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 256; ++c)
+        table[c] = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    return table;
+}();
+
+}  // namespace
+
+BookSortKeys::BookSortKeys(size_t expected_count, size_t expected_bytes) {
+    arena_.reserve(expected_bytes);
+    offsets_.reserve(expected_count + 1);
+    offsets_.push_back(0);
+}
+
+void BookSortKeys::Add(std::string_view title, std::string_view author_name) {
+    arena_.append(title);
+    arena_.push_back('\0');
+    auto folded = arena_.size();
+    arena_.append(author_name);
+    for (auto it = arena_.begin() + folded; it != arena_.end(); ++it)
+        *it = LOWER_CASE[static_cast<unsigned char>(*it)];
+    offsets_.push_back(arena_.size());
+}
+
+std::vector<uint32_t> BookSortKeys::SortedPermutation() const {
+    if (Size() > std::numeric_limits<uint32_t>::max())
+        throw std::length_error("Too many rows to sort");
+
+    // Most comparisons are settled by the cached prefixes without touching the arena
+    struct Entry {
+        uint64_t prefix;
+        uint32_t index;
+    };
+    std::vector<Entry> entries(Size());
+    for (uint32_t i = 0; i < entries.size(); ++i)
+        entries[i] = {KeyPrefix(Key(i)), i};
+    // Ties are broken by position, which keeps the sort stable without std::stable_sort's buffer
+    auto less = [this](const Entry& l, const Entry& r) {
+        if (l.prefix != r.prefix)
+            return l.prefix < r.prefix;
+        auto cmp = Key(l.index).compare(Key(r.index));
+        return cmp < 0 || (cmp == 0 && l.index < r.index);
+    };
+    if (entries.size() >= PARALLEL_SORT_THRESHOLD)
+        std::sort(std::execution::par, entries.begin(), entries.end(), less);
+    else
+        std::sort(entries.begin(), entries.end(), less);
+
+    std::vector<uint32_t> order;
+    order.reserve(entries.size());
+    for (const auto& entry: entries)
+        order.push_back(entry.index);
+    return order;
+}
+
+}  // namespace app
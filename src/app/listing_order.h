@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "use_cases.h"
+
+namespace app {
+
+// Inputs at least this long are sorted with the parallel algorithms
+constexpr size_t PARALLEL_SORT_THRESHOLD = 32'768;
+
+// Collation keys ordering books by title, then by lower-cased author name, both byte-wise.
+// Only ASCII letters are folded, while UnitOfWork::ForEachBook orders by the database's lower(),
+// so books with equal titles and non-ASCII author names may tie-break differently from it.
+// Each key is built once and stored back to back with the others;
+// titles cannot contain NUL, so a NUL separator makes a title sort before its extensions.
+class BookSortKeys {
+public:
+    explicit BookSortKeys(size_t expected_count = 0, size_t expected_bytes = 0);
+
+    void Add(std::string_view title, std::string_view author_name);
+
+    size_t Size() const noexcept {
+        return offsets_.size() - 1;
+    }
+    std::string_view Key(size_t index) const noexcept {
+        return std::string_view{arena_}.substr(offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    // Indexes of the added keys in ascending key order; equal keys keep the order they were added in
+    std::vector<uint32_t> SortedPermutation() const;
+
+private:
+    std::string arena_;
+    std::vector<size_t> offsets_;
+};
+
+// Sorts rows by the collation key of the book book_of returns for each
+template <typename Row, typename BookOf>
+void SortBooks(std::vector<Row>& rows, BookOf&& book_of) {
+    size_t key_bytes = 0;
+    for (const auto& row: rows) {
+        const items::BookInfo& book = book_of(row);
+        key_bytes += book.title.size() + 1 + book.author_name.size();
+    }
+    BookSortKeys keys{rows.size(), key_bytes};
+    for (const auto& row: rows) {
+        const items::BookInfo& book = book_of(row);
+        keys.Add(book.title, book.author_name);
+    }
+    std::vector<Row> sorted;
+    sorted.reserve(rows.size());
+    for (auto index: keys.SortedPermutation())
+        sorted.push_back(std::move(rows[index]));
+    rows = std::move(sorted);
+}
+
+inline void SortBooks(std::vector<items::BookInfo>& books) {
+    SortBooks(books, [](const items::BookInfo& book) -> const items::BookInfo& {
+        return book;
+    });
+}
+
+}  // namespace app
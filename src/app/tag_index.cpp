@@ -0,0 +1,151 @@
+#include "tag_index.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace app {
+
+void TagIndex::AddTag(const domain::BookId& book_id, const std::string& tag) {
+    std::unique_lock lock{mutex_};
+    AddTagLocked(GetOrAddOrdinal(book_id), tag);
+}
+
+void TagIndex::AddTags(const domain::BookId& book_id, const std::vector<std::string>& tags) {
+    if (tags.empty())
+        return;
+    std::unique_lock lock{mutex_};
+    AddTagsLocked(GetOrAddOrdinal(book_id), tags);
+}
+
+void TagIndex::SetTags(const domain::BookId& book_id, const std::vector<std::string>& tags) {
+    std::unique_lock lock{mutex_};
+    if (tags.empty()) {
+        RemoveBookLocked(book_id);
+        return;
+    }
+    auto ordinal = GetOrAddOrdinal(book_id);
+    RemoveTagsLocked(ordinal);
+    AddTagsLocked(ordinal, tags);
+}
+
+void TagIndex::RemoveBook(const domain::BookId& book_id) {
+    std::unique_lock lock{mutex_};
+    RemoveBookLocked(book_id);
+}
+
+void TagIndex::RemoveBookLocked(const domain::BookId& book_id) {
+    auto it = ordinals_.find(book_id);
+    if (it == ordinals_.end())
+        return;
+    RemoveTagsLocked(it->second);
+    free_ordinals_.push_back(it->second);
+    ordinals_.erase(it);
+}
+
+void TagIndex::Clear() {
+    std::unique_lock lock{mutex_};
+    tag_ids_.clear();
+    postings_.clear();
+    ordinals_.clear();
+    books_.clear();
+    book_tags_.clear();
+    free_ordinals_.clear();
+    tagged_books_ = {};
+}
+
+std::vector<domain::BookId> TagIndex::Find(const items::TagQuery& query) const {
+    std::shared_lock lock{mutex_};
+    util::Bitmap result;
+    if (!query.all_of.empty()) {
+        for (size_t i = 0; i < query.all_of.size(); ++i) {
+            auto it = tag_ids_.find(query.all_of[i]);
+            if (it == tag_ids_.end())
+                return {};
+            if (i == 0)
+                result = postings_[it->second];
+            else
+                result &= postings_[it->second];
+        }
+        if (!query.any_of.empty())
+            result &= UnionOf(query.any_of);
+    } else if (!query.any_of.empty()) {
+        result = UnionOf(query.any_of);
+    } else {
+        result = tagged_books_;
+    }
+    if (!query.none_of.empty())
+        result -= UnionOf(query.none_of);
+
+    std::vector<domain::BookId> book_ids;
+    book_ids.reserve(result.Cardinality());
+    result.ForEach([this, &book_ids](BookOrdinal ordinal) {
+        book_ids.push_back(books_[ordinal]);
+    });
+    return book_ids;
+}
+
+size_t TagIndex::BookCount() const {
+    std::shared_lock lock{mutex_};
+    return tagged_books_.Cardinality();
+}
+
+size_t TagIndex::TagCount() const {
+    std::shared_lock lock{mutex_};
+    return tag_ids_.size();
+}
+
+TagIndex::BookOrdinal TagIndex::GetOrAddOrdinal(const domain::BookId& book_id) {
+    auto [it, inserted] = ordinals_.try_emplace(book_id, 0);
+    if (!inserted)
+        return it->second;
+    if (!free_ordinals_.empty()) {
+        it->second = free_ordinals_.back();
+        free_ordinals_.pop_back();
+        books_[it->second] = book_id;
+    } else {
+        it->second = static_cast<BookOrdinal>(books_.size());
+        books_.push_back(book_id);
+        book_tags_.emplace_back();
+    }
+    return it->second;
+}
+
+TagIndex::TagId TagIndex::GetOrAddTag(const std::string& tag) {
+    auto [it, inserted] = tag_ids_.try_emplace(tag, static_cast<TagId>(postings_.size()));
+    if (inserted)
+        postings_.emplace_back();
+    return it->second;
+}
+
+void TagIndex::AddTagLocked(BookOrdinal ordinal, const std::string& tag) {
+    auto& book_tags = book_tags_[ordinal];
+    auto tag_id = GetOrAddTag(tag);
+    if (std::find(book_tags.begin(), book_tags.end(), tag_id) != book_tags.end())
+        return;
+    book_tags.push_back(tag_id);
+    postings_[tag_id].Add(ordinal);
+    tagged_books_.Add(ordinal);
+}
+
+void TagIndex::AddTagsLocked(BookOrdinal ordinal, const std::vector<std::string>& tags) {
+    for (const auto& tag: tags)
+        AddTagLocked(ordinal, tag);
+}
+
+void TagIndex::RemoveTagsLocked(BookOrdinal ordinal) {
+    for (auto tag_id: book_tags_[ordinal])
+        postings_[tag_id].Remove(ordinal);
+    book_tags_[ordinal].clear();
+    tagged_books_.Remove(ordinal);
+}
+
+util::Bitmap TagIndex::UnionOf(const std::vector<std::string>& names) const {
+    util::Bitmap result;
+    for (const auto& name: names) {
+        if (auto it = tag_ids_.find(name); it != tag_ids_.end())
+            result |= postings_[it->second];
+    }
+    return result;
+}
+
+}  // namespace app
@@ -0,0 +1,57 @@
+#pragma once
+#include <boost/uuid/uuid_hash.hpp>
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../domain/book.h"
+#include "../util/bitmap.h"
+#include "use_cases.h"
+
+namespace app {
+
+// In-process inverted index from tags to books. Tag names are dictionary-encoded to dense ids
+// and books to dense ordinals, and every tag keeps a compressed bitmap of the ordinals carrying it,
+// so boolean tag queries are a handful of bitmap operations. Only books with tags are indexed.
+class TagIndex {
+public:
+    void AddTag(const domain::BookId& book_id, const std::string& tag);
+    void AddTags(const domain::BookId& book_id, const std::vector<std::string>& tags);
+    // Replaces the tags of the book
+    void SetTags(const domain::BookId& book_id, const std::vector<std::string>& tags);
+    void RemoveBook(const domain::BookId& book_id);
+    void Clear();
+
+    std::vector<domain::BookId> Find(const items::TagQuery& query) const;
+
+    size_t BookCount() const;
+    size_t TagCount() const;
+
+private:
+    using BookOrdinal = uint32_t;
+    using TagId = uint32_t;
+
+    BookOrdinal GetOrAddOrdinal(const domain::BookId& book_id);
+    TagId GetOrAddTag(const std::string& tag);
+    void AddTagLocked(BookOrdinal ordinal, const std::string& tag);
+    void AddTagsLocked(BookOrdinal ordinal, const std::vector<std::string>& tags);
+    void RemoveTagsLocked(BookOrdinal ordinal);
+    void RemoveBookLocked(const domain::BookId& book_id);
+    // Union of the postings of the known tags among names
+    util::Bitmap UnionOf(const std::vector<std::string>& names) const;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, TagId> tag_ids_;
+    std::vector<util::Bitmap> postings_;
+    std::unordered_map<domain::BookId, BookOrdinal, util::TaggedHasher<domain::BookId>> ordinals_;
+    std::vector<domain::BookId> books_;
+    std::vector<std::vector<TagId>> book_tags_;
+    // Ordinals of removed books, reused so ordinals stay dense
+    std::vector<BookOrdinal> free_ordinals_;
+    util::Bitmap tagged_books_;
+};
+
+}  // namespace app
@@ -1,54 +1,102 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <optional>
 #include <memory>
 
+#include "../domain/author.h"
+#include "../domain/book.h"
+
 namespace items {
 
 struct AuthorInfo {
-    std::string id;
+    domain::AuthorId id;
     std::string name;
-    AuthorInfo(std::string&& _id, std::string&& _name): id(std::move(_id)), name(std::move(_name)) {}
+    AuthorInfo(domain::AuthorId _id, std::string&& _name): id(_id), name(std::move(_name)) {}
 };
 
 struct BookInfo {
-    std::string title, id, author_id, author_name;
+    std::string title;
+    domain::BookId id;
+    domain::AuthorId author_id;
+    std::string author_name;
     int publication_year;
-    BookInfo(std::string&& _title, std::string&& _id, std::string&& _author_id, std::string&& _author_name, int year):
+    BookInfo(std::string&& _title, domain::BookId _id, domain::AuthorId _author_id, std::string&& _author_name, int year):
             title(std::move(_title)),
-            publication_year(year),
-            id(std::move(_id)),
-            author_id(std::move(_author_id)),
-            author_name(std::move(_author_name)) {
+            id(_id),
+            author_id(_author_id),
+            author_name(std::move(_author_name)),
+            publication_year(year) {
     }
 };
 
+// A book with everything ShowBook and EditBook need, loaded in one round trip
+struct BookDetails {
+    BookInfo book;
+    std::vector<std::string> tags;
+};
+
+// Books carrying every tag of all_of, at least one tag of any_of (when given) and none of none_of
+struct TagQuery {
+    std::vector<std::string> all_of;
+    std::vector<std::string> any_of;
+    std::vector<std::string> none_of;
+};
+
+template <typename Item>
+struct Page {
+    std::vector<Item> items;
+    bool has_more = false;
+};
+
 } // namespace items
 
 namespace app {
 
+using BookVisitor = std::function<void(const items::BookInfo&)>;
+using BookTagVisitor = std::function<void(const domain::BookId&, std::string&& tag)>;
+
 class UseCases {
 public:
-    virtual std::optional<std::string> AddAuthor(const std::string& name) = 0;
-    virtual std::optional<std::string> AddBook(const std::string& title, size_t year, std::string author_id) = 0;
-    virtual void AddBookTags(const std::string& book_id, const std::vector<std::string>& book_tags) = 0;
+    virtual std::optional<domain::AuthorId> AddAuthor(const std::string& name) = 0;
+    virtual std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) = 0;
+    virtual void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) = 0;
     virtual std::vector<items::AuthorInfo> GetAuthors() = 0;
     virtual std::vector<items::BookInfo> GetBooks() = 0;
-    virtual std::vector<items::BookInfo> GetAuthorBooks(const std::string& author_id) = 0;
+    // Visits books sorted by title and author name as rows arrive, without materializing the list
+    virtual void ForEachBook(const BookVisitor& visitor) = 0;
+    // Keyset pages ordered by (name, id) and (title, id), starting after the given item
+    virtual items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit) = 0;
+    virtual items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) = 0;
+    virtual std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) = 0;
+    // Looks the author up in the read-write transaction, for commands that go on to change it
     virtual std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) = 0;
     virtual std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) = 0;
-    virtual std::optional<items::AuthorInfo> FindAuthorById(const std::string& author_id) = 0;
-    virtual void DeleteAuthor(const std::string& author_id) = 0;
-    virtual void EditAuthor(const std::string& author_id, const std::string& new_author_name) = 0;
-    virtual void DeleteBook(const std::string& book_id) = 0;
+    virtual std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string& book_title) = 0;
+    // Ranked prefix, substring and typo-tolerant matches on titles and author names
+    virtual std::vector<items::BookInfo> SearchBooks(const std::string& query, size_t limit) = 0;
+    // Answered from the in-memory tag index; empty when the index is not enabled
+    virtual std::vector<domain::BookId> FindBooksByTags(const items::TagQuery& query) = 0;
+    virtual std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) = 0;
+    virtual void DeleteAuthor(const domain::AuthorId& author_id) = 0;
+    virtual void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) = 0;
+    virtual void DeleteBook(const domain::BookId& book_id) = 0;
     virtual void EditBook(const items::BookInfo& book) = 0;
-    virtual std::optional<items::AuthorInfo> GetBookAuthor(const std::string& book_id) = 0;
-    virtual std::vector<std::string> GetBookTags(const std::string& book_id) = 0;
-    virtual void EditBookTags(const std::string& book_id, const std::vector<std::string>& new_tags) = 0;
+    virtual std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) = 0;
+    virtual std::vector<std::string> GetBookTags(const domain::BookId& book_id) = 0;
+    virtual void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags) = 0;
     virtual void EndTransaction() = 0;
     virtual void CancelTransaction() = 0;
+    // Commands between BeginBatch and CommitBatch share one transaction of the calling thread:
+    // EndTransaction leaves it open and CancelTransaction rolls back everything since BeginBatch
+    virtual void BeginBatch() = 0;
+    // False when a cancelled command rolled the batch back
+    virtual bool CommitBatch() = 0;
+    virtual void RollbackBatch() = 0;
+    // Transactions cancelled by the calling thread so far; commands cancel theirs when they fail
+    virtual size_t GetCancelledTransactions() = 0;
 
 protected:
     ~UseCases() = default;
@@ -56,32 +104,60 @@ protected:
 
 class UnitOfWork {
 public:
-    virtual std::optional<std::string> AddAuthor(const std::string& name) = 0;
-    virtual std::optional<std::string> AddBook(const std::string& title, size_t year, std::string author_id) = 0;
-    virtual void AddBookTags(const std::string& book_id, const std::vector<std::string>& book_tags) = 0;
+    virtual std::optional<domain::AuthorId> AddAuthor(const std::string& name) = 0;
+    virtual std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) = 0;
+    virtual void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) = 0;
     virtual std::vector<items::AuthorInfo> GetAuthors() = 0;
     virtual std::vector<items::BookInfo> GetBooks() = 0;
-    virtual std::vector<items::BookInfo> GetAuthorBooks(const std::string& author_id) = 0;
+    virtual void ForEachBook(const BookVisitor& visitor) = 0;
+    virtual items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit) = 0;
+    virtual items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) = 0;
+    virtual std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) = 0;
     virtual std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) = 0;
     virtual std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) = 0;
-    virtual void DeleteAuthor(const std::string& author_id) = 0;
-    virtual void DeleteAuthorBooks(const std::string& author_id) = 0;
-    virtual void DeleteBookTags(const std::string& book_id) = 0;
-    virtual void EditAuthor(const std::string& author_id, const std::string& new_author_name) = 0;
-    virtual void DeleteBook(const std::string& book_id) = 0;
+    virtual std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string& book_title) = 0;
+    virtual std::vector<items::BookInfo> SearchBooks(const std::string& query, size_t limit) = 0;
+    // Visits every (book, tag) pair, streamed as rows arrive
+    virtual void ForEachBookTag(const BookTagVisitor& visitor) = 0;
+    // Books and tags of the deleted author or book are removed by ON DELETE CASCADE
+    virtual void DeleteAuthor(const domain::AuthorId& author_id) = 0;
+    virtual void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) = 0;
+    virtual void DeleteBook(const domain::BookId& book_id) = 0;
     virtual void EditBook(const items::BookInfo& book) = 0;
-    virtual std::optional<items::AuthorInfo> GetBookAuthor(const std::string& book_id) = 0;
-    virtual std::optional<items::AuthorInfo> FindAuthorById(const std::string& author_id) = 0;
-    virtual std::vector<std::string> GetBookTags(const std::string& book_id) = 0;
-    virtual void EditBookTags(const std::string& book_id, const std::vector<std::string>& new_tags_str) = 0;
+    virtual std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) = 0;
+    virtual std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) = 0;
+    virtual std::vector<std::string> GetBookTags(const domain::BookId& book_id) = 0;
+    virtual void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags_str) = 0;
     virtual void Commit() = 0;
     virtual void Reset() = 0;
     virtual ~UnitOfWork() = default;
 };
 
+// Where the queries of a unit of work are served
+enum class ReadSource {
+    Primary,
+    // May lag behind commits made on the primary
+    Replica,
+};
+
+// What a factory creates a unit of work for
+struct UnitOfWorkTraits {
+    bool read_only = false;
+    ReadSource source = ReadSource::Primary;
+};
+
+// Wraps the units of work a factory creates, e.g. with a cache
+using UnitOfWorkDecorator =
+        std::function<std::unique_ptr<UnitOfWork>(std::unique_ptr<UnitOfWork>, const UnitOfWorkTraits&)>;
+
 class UnitOfWorkFactory {
 public:
     virtual std::unique_ptr<UnitOfWork>& GetUnitOfWork() = 0;
+    // For query-only use cases; returns the read-write unit of work when one is already open
+    virtual std::unique_ptr<UnitOfWork>& GetReadOnlyUnitOfWork() = 0;
+    // End every unit of work opened by the calling thread
+    virtual void CommitUnitOfWork() = 0;
+    virtual void ResetUnitOfWork() = 0;
     virtual void DeleteUnitOfWork() = 0;
     virtual ~UnitOfWorkFactory() = default;
 };
@@ -1,5 +1,7 @@
 #include "use_cases_impl.h"
 
+#include <stdexcept>
+
 #include "../domain/author.h"
 #include "../domain/book.h"
 
@@ -7,82 +9,215 @@ namespace app {
 using namespace domain;
 
 void UseCasesImpl::EndTransaction() {
-    factory_->GetUnitOfWork()->Commit();
-    factory_->DeleteUnitOfWork();
+    {
+        std::lock_guard lock{transactions_mutex_};
+        if (transactions_[std::this_thread::get_id()].in_batch)
+            return;
+    }
+    CommitTransaction();
 }
 
 void UseCasesImpl::CancelTransaction() {
-    factory_->GetUnitOfWork()->Reset();
-    factory_->DeleteUnitOfWork();
-}
-
-std::optional<std::string> UseCasesImpl::AddAuthor(const std::string& name) {
+    ResetTransaction();
+    std::lock_guard lock{transactions_mutex_};
+    auto& transactions = transactions_[std::this_thread::get_id()];
+    ++transactions.cancelled;
+    if (transactions.in_batch)
+        transactions.batch_cancelled = true;
+}
+
+void UseCasesImpl::BeginBatch() {
+    std::lock_guard lock{transactions_mutex_};
+    auto& transactions = transactions_[std::this_thread::get_id()];
+    if (transactions.in_batch)
+        throw std::logic_error("A batch is already open");
+    transactions.in_batch = true;
+    transactions.batch_cancelled = false;
+}
+
+bool UseCasesImpl::CommitBatch() {
+    bool cancelled;
+    {
+        std::lock_guard lock{transactions_mutex_};
+        auto& transactions = transactions_[std::this_thread::get_id()];
+        if (!transactions.in_batch)
+            throw std::logic_error("No batch is open");
+        transactions.in_batch = false;
+        cancelled = transactions.batch_cancelled;
+    }
+    // Commands after the one that cancelled the batch may have opened a new transaction
+    if (cancelled) {
+        ResetTransaction();
+        return false;
+    }
+    CommitTransaction();
+    return true;
+}
+
+void UseCasesImpl::RollbackBatch() {
+    {
+        std::lock_guard lock{transactions_mutex_};
+        transactions_[std::this_thread::get_id()].in_batch = false;
+    }
+    ResetTransaction();
+}
+
+size_t UseCasesImpl::GetCancelledTransactions() {
+    std::lock_guard lock{transactions_mutex_};
+    return transactions_[std::this_thread::get_id()].cancelled;
+}
+
+void UseCasesImpl::CommitTransaction() {
+    factory_->CommitUnitOfWork();
+    for (auto& change: TakeTagIndexChanges())
+        change(*tag_index_);
+}
+
+void UseCasesImpl::ResetTransaction() {
+    factory_->ResetUnitOfWork();
+    TakeTagIndexChanges();
+}
+
+void UseCasesImpl::LoadTagIndex() {
+    if (!tag_index_)
+        return;
+    tag_index_->Clear();
+    factory_->GetReadOnlyUnitOfWork()->ForEachBookTag([this](const domain::BookId& book_id, std::string&& tag) {
+        tag_index_->AddTag(book_id, tag);
+    });
+    factory_->CommitUnitOfWork();
+}
+
+void UseCasesImpl::StageTagIndexChange(TagIndexChange change) {
+    std::lock_guard lock{tag_changes_mutex_};
+    tag_changes_[std::this_thread::get_id()].push_back(std::move(change));
+}
+
+std::vector<UseCasesImpl::TagIndexChange> UseCasesImpl::TakeTagIndexChanges() {
+    std::lock_guard lock{tag_changes_mutex_};
+    auto it = tag_changes_.find(std::this_thread::get_id());
+    if (it == tag_changes_.end())
+        return {};
+    auto changes = std::move(it->second);
+    tag_changes_.erase(it);
+    return changes;
+}
+
+std::optional<domain::AuthorId> UseCasesImpl::AddAuthor(const std::string& name) {
     return factory_->GetUnitOfWork()->AddAuthor(name);
 }
 
-std::optional<std::string> UseCasesImpl::AddBook(const std::string &title, size_t year, std::string author_id) {
+std::optional<domain::BookId> UseCasesImpl::AddBook(const std::string &title, size_t year, const domain::AuthorId& author_id) {
     return factory_->GetUnitOfWork()->AddBook(title, year, author_id);
 }
 
 std::vector<items::AuthorInfo> UseCasesImpl::GetAuthors() {
-    return factory_->GetUnitOfWork()->GetAuthors();
+    return factory_->GetReadOnlyUnitOfWork()->GetAuthors();
 }
 
 std::vector<items::BookInfo> UseCasesImpl::GetBooks() {
-    return factory_->GetUnitOfWork()->GetBooks();
+    return factory_->GetReadOnlyUnitOfWork()->GetBooks();
+}
+
+void UseCasesImpl::ForEachBook(const BookVisitor& visitor) {
+    factory_->GetReadOnlyUnitOfWork()->ForEachBook(visitor);
+}
+
+items::Page<items::AuthorInfo> UseCasesImpl::GetAuthorsPage(const std::optional<items::AuthorInfo>& after,
+                                                            size_t limit) {
+    return factory_->GetReadOnlyUnitOfWork()->GetAuthorsPage(after, limit);
 }
 
-std::vector<items::BookInfo> UseCasesImpl::GetAuthorBooks(const std::string& author_id) {
-    return factory_->GetUnitOfWork()->GetAuthorBooks(author_id);
+items::Page<items::BookInfo> UseCasesImpl::GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) {
+    return factory_->GetReadOnlyUnitOfWork()->GetBooksPage(after, limit);
 }
 
+std::vector<items::BookInfo> UseCasesImpl::GetAuthorBooks(const domain::AuthorId& author_id) {
+    return factory_->GetReadOnlyUnitOfWork()->GetAuthorBooks(author_id);
+}
+
+// Callers add, edit or delete the author they look up, so the lookup runs in the write
+// transaction: a lagging replica could miss an author that was just added
 std::optional<items::AuthorInfo> UseCasesImpl::FindAuthorByName(const std::string& author_name) {
     return factory_->GetUnitOfWork()->FindAuthorByName(author_name);
 }
 
-std::optional<items::AuthorInfo> UseCasesImpl::FindAuthorById(const std::string &author_id) {
-    return factory_->GetUnitOfWork()->FindAuthorById(author_id);
+std::optional<items::AuthorInfo> UseCasesImpl::FindAuthorById(const domain::AuthorId& author_id) {
+    return factory_->GetReadOnlyUnitOfWork()->FindAuthorById(author_id);
 }
 
 std::vector<items::BookInfo> UseCasesImpl::FindBookByTitle(const std::string& book_title) {
-    return factory_->GetUnitOfWork()->FindBookByTitle(book_title);
+    return factory_->GetReadOnlyUnitOfWork()->FindBookByTitle(book_title);
 }
 
-void UseCasesImpl::AddBookTags(const std::string &book_id, const std::vector<std::string> &book_tags) {
-    factory_->GetUnitOfWork()->AddBookTags(book_id, book_tags);
+std::vector<items::BookDetails> UseCasesImpl::FindBookDetailsByTitle(const std::string& book_title) {
+    return factory_->GetReadOnlyUnitOfWork()->FindBookDetailsByTitle(book_title);
 }
 
-void UseCasesImpl::DeleteAuthor(const std::string &author_id) {
-    factory_->GetUnitOfWork()->DeleteAuthorBooks(author_id);
-    factory_->GetUnitOfWork()->DeleteAuthor(author_id);
+std::vector<domain::BookId> UseCasesImpl::FindBooksByTags(const items::TagQuery& query) {
+    if (!tag_index_)
+        return {};
+    return tag_index_->Find(query);
 }
 
-void UseCasesImpl::EditAuthor(const std::string &author_id, const std::string &new_author_name) {
+std::vector<items::BookInfo> UseCasesImpl::SearchBooks(const std::string& query, size_t limit) {
+    return factory_->GetReadOnlyUnitOfWork()->SearchBooks(query, limit);
+}
+
+void UseCasesImpl::AddBookTags(const domain::BookId& book_id, const std::vector<std::string> &book_tags) {
+    factory_->GetUnitOfWork()->AddBookTags(book_id, book_tags);
+    if (tag_index_) {
+        StageTagIndexChange([book_id, book_tags](TagIndex& index) {
+            index.AddTags(book_id, book_tags);
+        });
+    }
+}
+
+void UseCasesImpl::DeleteAuthor(const domain::AuthorId& author_id) {
+    auto& uow = factory_->GetUnitOfWork();
+    if (tag_index_) {
+        // The cascade removes the author's books without naming them, so collect them first
+        for (const auto& book: uow->GetAuthorBooks(author_id)) {
+            StageTagIndexChange([book_id = book.id](TagIndex& index) {
+                index.RemoveBook(book_id);
+            });
+        }
+    }
+    uow->DeleteAuthor(author_id);
+}
+
+void UseCasesImpl::EditAuthor(const domain::AuthorId& author_id, const std::string &new_author_name) {
     factory_->GetUnitOfWork()->EditAuthor(author_id, new_author_name);
 }
 
-std::optional<items::AuthorInfo> UseCasesImpl::GetBookAuthor(const std::string &book_id) {
-    auto author_info = factory_->GetUnitOfWork()->GetBookAuthor(book_id);
-    if (author_info.has_value())
-        return factory_->GetUnitOfWork()->FindAuthorById(author_info.value().id);
-    return std::nullopt;
+std::optional<items::AuthorInfo> UseCasesImpl::GetBookAuthor(const domain::BookId& book_id) {
+    return factory_->GetReadOnlyUnitOfWork()->GetBookAuthor(book_id);
 }
 
-std::vector<std::string> UseCasesImpl::GetBookTags(const std::string &book_id) {
-    return factory_->GetUnitOfWork()->GetBookTags(book_id);
+std::vector<std::string> UseCasesImpl::GetBookTags(const domain::BookId& book_id) {
+    return factory_->GetReadOnlyUnitOfWork()->GetBookTags(book_id);
 }
 
-void UseCasesImpl::DeleteBook(const std::string &book_id) {
-    factory_->GetUnitOfWork()->DeleteBookTags(book_id);
+void UseCasesImpl::DeleteBook(const domain::BookId& book_id) {
     factory_->GetUnitOfWork()->DeleteBook(book_id);
+    if (tag_index_) {
+        StageTagIndexChange([book_id](TagIndex& index) {
+            index.RemoveBook(book_id);
+        });
+    }
 }
 
 void UseCasesImpl::EditBook(const items::BookInfo &book) {
     factory_->GetUnitOfWork()->EditBook(book);
 }
 
-void UseCasesImpl::EditBookTags(const std::string &book_id, const std::vector<std::string> &new_tags) {
+void UseCasesImpl::EditBookTags(const domain::BookId& book_id, const std::vector<std::string> &new_tags) {
     factory_->GetUnitOfWork()->EditBookTags(book_id, new_tags);
+    if (tag_index_) {
+        StageTagIndexChange([book_id, new_tags](TagIndex& index) {
+            index.SetTags(book_id, new_tags);
+        });
+    }
 }
 
 }  // namespace app
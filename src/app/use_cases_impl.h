@@ -1,36 +1,77 @@
 #pragma once
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 #include "../domain/author_fwd.h"
+#include "tag_index.h"
 #include "use_cases.h"
 
 namespace app {
 
 class UseCasesImpl : public UseCases {
 public:
-    explicit UseCasesImpl(UnitOfWorkFactory* factory) {
+    explicit UseCasesImpl(UnitOfWorkFactory* factory, TagIndex* tag_index = nullptr) {
         factory_ = factory;
+        tag_index_ = tag_index;
     }
 
-    std::optional<std::string> AddAuthor(const std::string& name) override;
-    std::optional<std::string> AddBook(const std::string& title, size_t year, std::string author_id) override;
-    void AddBookTags(const std::string& book_id, const std::vector<std::string>& book_tags) override;
+    // Fills the tag index from the database; does nothing without an index
+    void LoadTagIndex();
+
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override;
+    std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) override;
+    void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) override;
     std::vector<items::AuthorInfo> GetAuthors() override;
     std::vector<items::BookInfo> GetBooks() override;
-    std::vector<items::BookInfo> GetAuthorBooks(const std::string& author_id) override;
+    void ForEachBook(const BookVisitor& visitor) override;
+    items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit) override;
+    items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) override;
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) override;
     std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) override;
-    std::optional<items::AuthorInfo> FindAuthorById(const std::string& author_id) override;
+    std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) override;
     std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) override;
-    void DeleteAuthor(const std::string& author_id) override;
-    void EditAuthor(const std::string& author_id, const std::string& new_author_name) override;
-    void DeleteBook(const std::string& book_id) override;
+    std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string& book_title) override;
+    std::vector<items::BookInfo> SearchBooks(const std::string& query, size_t limit) override;
+    std::vector<domain::BookId> FindBooksByTags(const items::TagQuery& query) override;
+    void DeleteAuthor(const domain::AuthorId& author_id) override;
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override;
+    void DeleteBook(const domain::BookId& book_id) override;
     void EditBook(const items::BookInfo& book) override;
-    std::optional<items::AuthorInfo> GetBookAuthor(const std::string& book_id) override;
-    std::vector<std::string> GetBookTags(const std::string& book_id) override;
-    void EditBookTags(const std::string& book_id, const std::vector<std::string>& new_tags) override;
+    std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) override;
+    std::vector<std::string> GetBookTags(const domain::BookId& book_id) override;
+    void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags) override;
     void EndTransaction() override;
     void CancelTransaction() override;
+    void BeginBatch() override;
+    bool CommitBatch() override;
+    void RollbackBatch() override;
+    size_t GetCancelledTransactions() override;
 
 private:
+    using TagIndexChange = std::function<void(TagIndex&)>;
+
+    // Batch state and failure count of one thread's transactions
+    struct ThreadTransactions {
+        bool in_batch = false;
+        bool batch_cancelled = false;
+        size_t cancelled = 0;
+    };
+
+    void CommitTransaction();
+    void ResetTransaction();
+
+    // Index changes are applied when the calling thread's transaction commits and dropped when it is cancelled
+    void StageTagIndexChange(TagIndexChange change);
+    std::vector<TagIndexChange> TakeTagIndexChanges();
+
     UnitOfWorkFactory* factory_;
+    TagIndex* tag_index_;
+    std::mutex tag_changes_mutex_;
+    std::unordered_map<std::thread::id, std::vector<TagIndexChange>> tag_changes_;
+    std::mutex transactions_mutex_;
+    std::unordered_map<std::thread::id, ThreadTransactions> transactions_;
 };
 
 
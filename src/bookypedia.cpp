@@ -1,30 +1,144 @@
 #include "bookypedia.h"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 
+#include "bulk/catalog_reader.h"
 #include "menu/menu.h"
+#include "postgres/bulk_loader.h"
 #include "postgres/postgres.h"
+#include "ui/batch_runner.h"
 #include "ui/view.h"
+#include "util/tagged_uuid.h"
 
 namespace bookypedia {
 
 using namespace std::literals;
 
+namespace {
+
+// Rate of a step that may finish within the clock's resolution
+size_t RowsPerSecond(size_t rows, std::chrono::steady_clock::duration elapsed) {
+    elapsed = std::max(elapsed, std::chrono::steady_clock::duration{1});
+    return static_cast<size_t>(rows / std::chrono::duration<double>(elapsed).count());
+}
+
+postgres::ConnectionPoolConfig MakePoolConfig(const AppConfig& config, const std::string& db_url) {
+    return {db_url, config.db_pool_min_size, config.db_pool_max_size, config.db_acquire_timeout};
+}
+
+std::optional<postgres::ConnectionPoolConfig> MakeReplicaPoolConfig(const AppConfig& config) {
+    if (!config.db_replica_url.has_value())
+        return std::nullopt;
+    return MakePoolConfig(config, *config.db_replica_url);
+}
+
+}  // namespace
+
 Application::Application(const AppConfig& config)
-    : db_{pqxx::connection{config.db_url}} {
+    : snapshot_reads_{config.db_snapshot_reads}
+    , use_tag_index_{config.tag_index}
+    , output_format_{config.output_format}
+    , db_{MakePoolConfig(config, config.db_url), MakeReplicaPoolConfig(config)} {
+    util::SetUUIDVersion(config.time_ordered_ids ? util::UUIDVersion::TimeOrdered : util::UUIDVersion::Random);
+    if (config.author_cache_size > 0)
+        author_cache_ = std::make_unique<app::AuthorCache>(config.author_cache_size);
+    if (config.catalog_snapshot)
+        catalog_snapshot_ = std::make_unique<app::CatalogSnapshotStore>();
+    factory_->SetDecorator([this](std::unique_ptr<app::UnitOfWork> unit_of_work, const app::UnitOfWorkTraits& traits) {
+        if (author_cache_)
+            unit_of_work = std::make_unique<app::CachingUnitOfWork>(std::move(unit_of_work), *author_cache_,
+                                                                    traits.source);
+        if (catalog_snapshot_) {
+            // Loading the catalog inside a write transaction would slow the write down only to be
+            // invalidated by its commit
+            const auto loading = traits.read_only ? app::SnapshotLoading::Load : app::SnapshotLoading::UseCurrent;
+            unit_of_work = std::make_unique<app::SnapshotUnitOfWork>(std::move(unit_of_work), *catalog_snapshot_,
+                                                                     loading, traits.source);
+        }
+        return unit_of_work;
+    });
 }
 
 void Application::Run() {
     menu::Menu menu{std::cin, std::cout};
-    menu.AddAction("Help"s, {}, "Show instructions"s, [&menu](std::istream&) {
+    menu.AddAction("Help"s, {}, "Show instructions"s, [&menu](menu::CommandArgs) {
         menu.ShowInstructions();
         return true;
     });
-    menu.AddAction("Exit"s, {}, "Exit program"s, [&menu](std::istream&) {
+    menu.AddAction("Exit"s, {}, "Exit program"s, [&menu](menu::CommandArgs) {
         return false;
     });
-    ui::View view{menu, use_cases_, std::cin, std::cout};
+    ui::View view{menu, use_cases_, std::cin, std::cout, output_format_};
+    use_cases_.LoadTagIndex();
     menu.Run();
 }
 
+bool Application::RunBatch(const BatchConfig& config, std::ostream& log) {
+    std::ifstream script{config.path};
+    if (!script)
+        throw std::runtime_error("Failed to open "s + config.path);
+    // Prompts of the commands are answered by the script lines that follow them
+    menu::Menu menu{script, std::cout};
+    ui::View view{menu, use_cases_, script, std::cout, output_format_};
+    use_cases_.LoadTagIndex();
+    ui::BatchRunner runner{menu, use_cases_, script, log,
+                           config.continue_on_error ? ui::ErrorPolicy::Continue : ui::ErrorPolicy::Stop};
+    return runner.Run().failed == 0;
+}
+
+void Application::Import(const ImportConfig& config, std::ostream& output) {
+    using Clock = std::chrono::steady_clock;
+
+    std::ifstream input{config.path};
+    if (!input)
+        throw std::runtime_error("Failed to open "s + config.path);
+    bulk::CatalogReader reader{input, bulk::FormatFromPath(config.path)};
+    postgres::BulkLoader loader{db_.GetPool()};
+
+    std::vector<bulk::BookRecord> batch;
+    batch.reserve(config.batch_size);
+    size_t committed = 0;
+    size_t total_rows = 0;
+    const auto start = Clock::now();
+    try {
+        while (committed < config.resume_from && reader.Next())
+            ++committed;
+        if (committed > 0)
+            output << "Skipped "sv << committed << " records"sv << std::endl;
+
+        bool has_more = true;
+        while (has_more) {
+            auto record = reader.Next();
+            has_more = record.has_value();
+            if (has_more)
+                batch.push_back(std::move(*record));
+            if (batch.size() < config.batch_size && has_more)
+                continue;
+            if (batch.empty())
+                break;
+
+            const auto batch_start = Clock::now();
+            auto stats = loader.LoadBatch(batch);
+            const auto elapsed = Clock::now() - batch_start;
+            committed += batch.size();
+            total_rows += stats.Rows();
+            output << "Committed "sv << committed << " records: "sv << stats.books << " books, "sv
+                   << stats.new_authors << " new authors, "sv << stats.tags << " tags, "sv
+                   << RowsPerSecond(stats.Rows(), elapsed) << " rows/s"sv << std::endl;
+            batch.clear();
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Import failed: "s + e.what() + "\n"s + std::to_string(committed) +
+                                 " records are committed, resume with --resume-from "s +
+                                 std::to_string(committed));
+    }
+
+    const auto elapsed = Clock::now() - start;
+    output << "Imported "sv << total_rows << " rows in "sv << std::chrono::duration<double>(elapsed).count()
+           << " s ("sv << RowsPerSecond(total_rows, elapsed) << " rows/s)"sv << std::endl;
+}
+
 }  // namespace bookypedia
@@ -1,13 +1,49 @@
 #pragma once
 #include <pqxx/pqxx>
 
+#include <chrono>
+#include <optional>
+
+#include "app/caching_unit_of_work.h"
+#include "app/catalog_snapshot.h"
 #include "app/use_cases_impl.h"
 #include "postgres/postgres.h"
+#include "ui/record_writer.h"
 
 namespace bookypedia {
 
 struct AppConfig {
     std::string db_url;
+    size_t db_pool_min_size = 1;
+    size_t db_pool_max_size = 4;
+    std::chrono::milliseconds db_acquire_timeout{5000};
+    // Query-only use cases go to the replica when set
+    std::optional<std::string> db_replica_url;
+    bool db_snapshot_reads = false;
+    // New ids are UUIDv7 so inserts append to the primary key indexes
+    bool time_ordered_ids = false;
+    // Keeps an in-memory tag index for boolean tag queries. Loading it reads every book tag at
+    // startup and author deletes then list the author's books, so it is off unless asked for.
+    bool tag_index = false;
+    // Authors cached in memory across units of work; 0 turns the cache off
+    size_t author_cache_size = 10000;
+    // Serves book listings and lookups from an in-memory copy of the catalog
+    bool catalog_snapshot = false;
+    // Format of ShowBooks and ShowAuthors listings
+    ui::OutputFormat output_format = ui::OutputFormat::Text;
+};
+
+struct ImportConfig {
+    std::string path;
+    size_t batch_size = 10000;
+    // Number of leading records that were committed by a previous run
+    size_t resume_from = 0;
+};
+
+struct BatchConfig {
+    std::string path;
+    // Keep going after a failed command instead of stopping the script
+    bool continue_on_error = false;
 };
 
 class Application {
@@ -15,12 +51,23 @@ public:
     explicit Application(const AppConfig& config);
 
     void Run();
+    void Import(const ImportConfig& config, std::ostream& output);
+    // Runs the commands of a script; false when any of them failed
+    bool RunBatch(const BatchConfig& config, std::ostream& log);
 
 private:
+    bool snapshot_reads_;
+    bool use_tag_index_;
+    ui::OutputFormat output_format_;
     postgres::Database db_;
-    std::unique_ptr<app::UnitOfWorkFactory> factory_ =
-            std::make_unique<postgres::UnitOfWorkFactoryImpl>(db_.GetConnection());
-    app::UseCasesImpl use_cases_{factory_.get()};
+    // Declared before the factory so they outlive the units of work referring to them
+    std::unique_ptr<app::AuthorCache> author_cache_;
+    std::unique_ptr<app::CatalogSnapshotStore> catalog_snapshot_;
+    std::unique_ptr<postgres::UnitOfWorkFactoryImpl> factory_ =
+            std::make_unique<postgres::UnitOfWorkFactoryImpl>(db_.GetPool(), db_.GetReplicaPool(),
+                                                              snapshot_reads_);
+    app::TagIndex tag_index_;
+    app::UseCasesImpl use_cases_{factory_.get(), use_tag_index_ ? &tag_index_ : nullptr};
 };
 
 }  // namespace bookypedia
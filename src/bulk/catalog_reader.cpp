@@ -0,0 +1,134 @@
+#include "catalog_reader.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/json.hpp>
+#include <charconv>
+#include <istream>
+#include <set>
+
+namespace bulk {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t CSV_COLUMNS = 4;
+
+std::vector<std::string> SplitCsvLine(std::string_view line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    if (quoted)
+        throw std::invalid_argument("unterminated quoted field");
+    return fields;
+}
+
+std::vector<std::string> NormalizeTags(std::vector<std::string>&& tags) {
+    for (auto& tag: tags)
+        boost::algorithm::trim(tag);
+    std::set<std::string> unique{std::make_move_iterator(tags.begin()), std::make_move_iterator(tags.end())};
+    unique.erase(""s);
+    return {unique.begin(), unique.end()};
+}
+
+int ParseYear(std::string_view str) {
+    int year = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), year);
+    if (ec != std::errc{} || ptr != str.data() + str.size())
+        throw std::invalid_argument("invalid publication year");
+    return year;
+}
+
+void Validate(BookRecord& record) {
+    boost::algorithm::trim(record.title);
+    boost::algorithm::trim(record.author_name);
+    if (record.title.empty())
+        throw std::invalid_argument("empty title");
+    if (record.author_name.empty())
+        throw std::invalid_argument("empty author name");
+}
+
+}  // namespace
+
+CatalogFormat FormatFromPath(std::string_view path) {
+    if (path.ends_with(".csv"sv))
+        return CatalogFormat::Csv;
+    if (path.ends_with(".jsonl"sv) || path.ends_with(".ndjson"sv))
+        return CatalogFormat::JsonLines;
+    throw std::invalid_argument("Unknown catalog format: "s + std::string{path});
+}
+
+CatalogReader::CatalogReader(std::istream& input, CatalogFormat format)
+    : input_{input}
+    , format_{format} {
+    if (format_ == CatalogFormat::Csv && std::getline(input_, line_))
+        ++line_num_;
+}
+
+std::optional<BookRecord> CatalogReader::Next() {
+    while (std::getline(input_, line_)) {
+        ++line_num_;
+        if (boost::algorithm::all(line_, boost::algorithm::is_space()))
+            continue;
+        try {
+            auto record = format_ == CatalogFormat::Csv ? ParseCsv(line_) : ParseJson(line_);
+            Validate(record);
+            ++records_;
+            return record;
+        } catch (const std::exception& e) {
+            throw CatalogParseError(line_num_, e.what());
+        }
+    }
+    return std::nullopt;
+}
+
+BookRecord CatalogReader::ParseCsv(std::string_view line) const {
+    auto fields = SplitCsvLine(line);
+    if (fields.size() < CSV_COLUMNS - 1 || fields.size() > CSV_COLUMNS)
+        throw std::invalid_argument("expected title,author,year[,tags]");
+
+    BookRecord record;
+    record.title = std::move(fields[0]);
+    record.author_name = std::move(fields[1]);
+    boost::algorithm::trim(fields[2]);
+    record.publication_year = ParseYear(fields[2]);
+    if (fields.size() == CSV_COLUMNS && !fields[3].empty()) {
+        std::vector<std::string> tags;
+        boost::algorithm::split(tags, fields[3], boost::is_any_of(";"));
+        record.tags = NormalizeTags(std::move(tags));
+    }
+    return record;
+}
+
+BookRecord CatalogReader::ParseJson(std::string_view line) const {
+    auto value = boost::json::parse(boost::json::string_view{line.data(), line.size()});
+    const auto& object = value.as_object();
+
+    BookRecord record;
+    record.title = boost::json::value_to<std::string>(object.at("title"));
+    record.author_name = boost::json::value_to<std::string>(object.at("author"));
+    record.publication_year = boost::json::value_to<int>(object.at("year"));
+    if (const auto* tags = object.if_contains("tags"))
+        record.tags = NormalizeTags(boost::json::value_to<std::vector<std::string>>(*tags));
+    return record;
+}
+
+}  // namespace bulk
@@ -0,0 +1,66 @@
+#pragma once
+#include <iosfwd>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bulk {
+
+struct BookRecord {
+    std::string title;
+    std::string author_name;
+    int publication_year = 0;
+    std::vector<std::string> tags;
+};
+
+enum class CatalogFormat {
+    Csv,
+    JsonLines
+};
+
+class CatalogParseError : public std::runtime_error {
+public:
+    CatalogParseError(size_t line, const std::string& what)
+        : std::runtime_error("line " + std::to_string(line) + ": " + what)
+        , line_{line} {
+    }
+
+    size_t GetLine() const noexcept {
+        return line_;
+    }
+
+private:
+    size_t line_;
+};
+
+// Picks the format from the file extension: .csv, .jsonl or .ndjson
+CatalogFormat FormatFromPath(std::string_view path);
+
+// Reads book records one at a time, so a catalog never has to fit in memory.
+// CSV files start with a header row; columns are title,author,year,tags with tags separated by ';'.
+// JSON lines hold one object per line: {"title": ..., "author": ..., "year": ..., "tags": [...]}.
+class CatalogReader {
+public:
+    CatalogReader(std::istream& input, CatalogFormat format);
+
+    std::optional<BookRecord> Next();
+
+    // Number of records returned so far
+    size_t GetRecordCount() const noexcept {
+        return records_;
+    }
+
+private:
+    BookRecord ParseCsv(std::string_view line) const;
+    BookRecord ParseJson(std::string_view line) const;
+
+    std::istream& input_;
+    CatalogFormat format_;
+    std::string line_;
+    size_t line_num_ = 0;
+    size_t records_ = 0;
+};
+
+}  // namespace bulk
@@ -1,6 +1,9 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "bookypedia.h"
 
@@ -9,6 +12,15 @@ using namespace std::literals;
 namespace {
 
 constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_DB_URL"};
+constexpr const char DB_POOL_MIN_ENV_NAME[]{"BOOKYPEDIA_DB_POOL_MIN"};
+constexpr const char DB_POOL_MAX_ENV_NAME[]{"BOOKYPEDIA_DB_POOL_MAX"};
+constexpr const char DB_ACQUIRE_TIMEOUT_ENV_NAME[]{"BOOKYPEDIA_DB_ACQUIRE_TIMEOUT_MS"};
+constexpr const char DB_REPLICA_URL_ENV_NAME[]{"BOOKYPEDIA_DB_REPLICA_URL"};
+constexpr const char DB_SNAPSHOT_READS_ENV_NAME[]{"BOOKYPEDIA_DB_SNAPSHOT_READS"};
+constexpr const char TIME_ORDERED_IDS_ENV_NAME[]{"BOOKYPEDIA_TIME_ORDERED_IDS"};
+constexpr const char TAG_INDEX_ENV_NAME[]{"BOOKYPEDIA_TAG_INDEX"};
+constexpr const char AUTHOR_CACHE_SIZE_ENV_NAME[]{"BOOKYPEDIA_AUTHOR_CACHE_SIZE"};
+constexpr const char CATALOG_SNAPSHOT_ENV_NAME[]{"BOOKYPEDIA_CATALOG_SNAPSHOT"};
 
 bookypedia::AppConfig GetConfigFromEnv() {
     bookypedia::AppConfig config;
@@ -17,15 +29,107 @@ bookypedia::AppConfig GetConfigFromEnv() {
     } else {
         throw std::runtime_error(DB_URL_ENV_NAME + " environment variable not found"s);
     }
+    if (const auto* min_size = std::getenv(DB_POOL_MIN_ENV_NAME)) {
+        config.db_pool_min_size = std::stoul(min_size);
+    }
+    if (const auto* max_size = std::getenv(DB_POOL_MAX_ENV_NAME)) {
+        config.db_pool_max_size = std::stoul(max_size);
+    }
+    if (const auto* timeout = std::getenv(DB_ACQUIRE_TIMEOUT_ENV_NAME)) {
+        config.db_acquire_timeout = std::chrono::milliseconds{std::stol(timeout)};
+    }
+    if (const auto* replica_url = std::getenv(DB_REPLICA_URL_ENV_NAME)) {
+        config.db_replica_url = replica_url;
+    }
+    if (const auto* snapshot_reads = std::getenv(DB_SNAPSHOT_READS_ENV_NAME)) {
+        config.db_snapshot_reads = snapshot_reads == "1"sv;
+    }
+    if (const auto* time_ordered_ids = std::getenv(TIME_ORDERED_IDS_ENV_NAME)) {
+        config.time_ordered_ids = time_ordered_ids == "1"sv;
+    }
+    if (const auto* tag_index = std::getenv(TAG_INDEX_ENV_NAME)) {
+        config.tag_index = tag_index == "1"sv;
+    }
+    if (const auto* cache_size = std::getenv(AUTHOR_CACHE_SIZE_ENV_NAME)) {
+        config.author_cache_size = std::stoul(cache_size);
+    }
+    if (const auto* catalog_snapshot = std::getenv(CATALOG_SNAPSHOT_ENV_NAME)) {
+        config.catalog_snapshot = catalog_snapshot == "1"sv;
+    }
+    return config;
+}
+
+// Takes --format=<text|jsonl|csv|tsv> out of the arguments; the last one wins
+ui::OutputFormat ExtractOutputFormat(std::vector<const char*>& args) {
+    constexpr auto FORMAT_OPTION = "--format="sv;
+    auto format = ui::OutputFormat::Text;
+    std::erase_if(args, [&format, FORMAT_OPTION](std::string_view arg) {
+        if (!arg.starts_with(FORMAT_OPTION))
+            return false;
+        format = ui::ParseOutputFormat(arg.substr(FORMAT_OPTION.size()));
+        return true;
+    });
+    return format;
+}
+
+// bookypedia --batch <file> [--on-error stop|continue]
+bookypedia::BatchConfig ParseBatchArgs(int argc, const char* argv[]) {
+    if (argc != 3 && argc != 5)
+        throw std::invalid_argument("Usage: bookypedia --batch <file> [--on-error stop|continue]");
+    bookypedia::BatchConfig config;
+    config.path = argv[2];
+    if (argc == 5) {
+        if (argv[3] != "--on-error"sv)
+            throw std::invalid_argument("Unknown option "s + argv[3]);
+        if (argv[4] == "continue"sv)
+            config.continue_on_error = true;
+        else if (argv[4] != "stop"sv)
+            throw std::invalid_argument("Unknown error policy "s + argv[4]);
+    }
+    return config;
+}
+
+// bookypedia import <file> [--batch-size N] [--resume-from N]
+bookypedia::ImportConfig ParseImportArgs(int argc, const char* argv[]) {
+    if (argc < 3)
+        throw std::invalid_argument("Usage: bookypedia import <file> [--batch-size N] [--resume-from N]");
+    bookypedia::ImportConfig config;
+    config.path = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("Missing value for "s + std::string{arg});
+        if (arg == "--batch-size"sv) {
+            config.batch_size = std::stoul(argv[++i]);
+            if (config.batch_size == 0)
+                throw std::invalid_argument("Batch size must be positive");
+        } else if (arg == "--resume-from"sv) {
+            config.resume_from = std::stoul(argv[++i]);
+        } else {
+            throw std::invalid_argument("Unknown option "s + std::string{arg});
+        }
+    }
     return config;
 }
 
 }  // namespace
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] const char* argv[]) {
+int main(int argc, const char* argv[]) {
     try {
-        bookypedia::Application app{GetConfigFromEnv()};
-        app.Run();
+        std::vector<const char*> args{argv, argv + argc};
+        auto config = GetConfigFromEnv();
+        config.output_format = ExtractOutputFormat(args);
+        const int arg_count = static_cast<int>(args.size());
+
+        bookypedia::Application app{config};
+        if (arg_count >= 2 && args[1] == "import"sv) {
+            app.Import(ParseImportArgs(arg_count, args.data()), std::cout);
+        } else if (arg_count >= 2 && args[1] == "--batch"sv) {
+            if (!app.RunBatch(ParseBatchArgs(arg_count, args.data()), std::cerr))
+                return EXIT_FAILURE;
+        } else {
+            app.Run();
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
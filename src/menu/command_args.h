@@ -0,0 +1,69 @@
+#pragma once
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+namespace menu {
+
+// Whitespace as std::istream's operator>> skips it in the "C" locale
+constexpr bool IsSpace(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+constexpr std::string_view TrimLeft(std::string_view text) noexcept {
+    size_t pos = 0;
+    while (pos < text.size() && IsSpace(text[pos]))
+        ++pos;
+    return text.substr(pos);
+}
+
+constexpr std::string_view Trim(std::string_view text) noexcept {
+    text = TrimLeft(text);
+    while (!text.empty() && IsSpace(text.back()))
+        text.remove_suffix(1);
+    return text;
+}
+
+// Arguments of a command: the rest of the command line, read front to back without copying.
+// Views into the line are valid only while the handler runs.
+class CommandArgs {
+public:
+    constexpr explicit CommandArgs(std::string_view text = {}) noexcept
+        : text_{text} {
+    }
+
+    // The next whitespace-separated token; empty when none is left
+    constexpr std::string_view NextToken() noexcept {
+        text_ = TrimLeft(text_);
+        size_t end = 0;
+        while (end < text_.size() && !IsSpace(text_[end]))
+            ++end;
+        auto token = text_.substr(0, end);
+        text_.remove_prefix(end);
+        return token;
+    }
+
+    // Parses a leading integer; on failure the value is zeroed and the arguments are left as they were
+    template <typename Integer>
+    bool Next(Integer& value) noexcept {
+        static_assert(std::is_integral_v<Integer>);
+        auto text = TrimLeft(text_);
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{}) {
+            value = 0;
+            return false;
+        }
+        text_ = text.substr(end - text.data());
+        return true;
+    }
+
+    // Everything not read yet, without surrounding whitespace
+    constexpr std::string_view Rest() const noexcept {
+        return Trim(text_);
+    }
+
+private:
+    std::string_view text_;
+};
+
+}  // namespace menu
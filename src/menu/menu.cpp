@@ -1,9 +1,20 @@
 #include "menu.h"
+#include <algorithm>
 #include <iomanip>
-#include <sstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
 
 namespace menu {
 
+namespace {
+
+// Names whose full hashes coincide can never be separated; give up well before memory runs out
+constexpr size_t MAX_DISPATCH_TABLE_SIZE = size_t{1} << 16;
+
+}  // namespace
+
 Menu::Menu(std::istream& input, std::ostream& output)
     : input_{input}
     , output_{output} {
@@ -17,18 +28,46 @@ void Menu::AddAction(std::string action_name, std::string args, std::string desc
              .second) {
         throw std::invalid_argument("A command has been added already");
     }
+    dispatch_table_stale_ = true;
 }
 
 void Menu::Run() {
     std::string line;
     while (std::getline(input_, line)) {
-        std::istringstream cmd_stream{std::move(line)};
-        if (!ParseCommand(cmd_stream)) {
+        if (Execute(line) == Result::Exit) {
             break;
         }
     }
 }
 
+Menu::Result Menu::Execute(std::string_view line) {
+    using namespace std::literals;
+
+    if (dispatch_table_stale_) {
+        BuildDispatchTable();
+    }
+    CommandArgs args{line};
+    const auto cmd = args.NextToken();
+    if (cmd.empty()) {
+        output_ << "Invalid command"sv << std::endl;
+        return Result::Failed;
+    }
+    const auto action = FindAction(cmd);
+    if (!action) {
+        output_ << "Command '"sv << cmd << "' has not been found."sv << std::endl;
+        return Result::Failed;
+    }
+    try {
+        if (!action->second.handler(args)) {
+            return Result::Exit;
+        }
+    } catch (const std::exception& e) {
+        output_ << e.what() << std::endl;
+        return Result::Failed;
+    }
+    return Result::Continue;
+}
+
 void Menu::ShowInstructions() const {
     if (actions_.empty()) {
         return;
@@ -61,26 +100,33 @@ void Menu::ShowInstructions() const {
     restore_flags();
 }
 
-bool Menu::ParseCommand(std::istream& input) {
-    using namespace std::literals;
-
-    try {
-        std::string cmd;
-        if (input >> cmd) {
-            if (const auto it = actions_.find(cmd); it != actions_.cend()) {
-                if (!it->second.handler(input)) {
-                    return false;
-                }
-            } else {
-                output_ << "Command '"sv << cmd << "' has not been found."sv << std::endl;
-            }
-        } else {
-            output_ << "Invalid command"sv << std::endl;
+void Menu::BuildDispatchTable() {
+    const std::hash<std::string_view> hasher;
+    // Grow the power-of-two table until no two names share a slot
+    for (size_t size = 2; ; size *= 2) {
+        if (size > MAX_DISPATCH_TABLE_SIZE) {
+            throw std::logic_error("Failed to build the command dispatch table");
+        }
+        if (size < actions_.size() * 2) {
+            continue;
+        }
+        std::vector<const Action*> table(size, nullptr);
+        const bool collided = std::any_of(actions_.cbegin(), actions_.cend(), [&](const Action& action) {
+            auto& slot = table[hasher(action.first) & (size - 1)];
+            return std::exchange(slot, &action) != nullptr;
+        });
+        if (!collided) {
+            dispatch_table_ = std::move(table);
+            dispatch_mask_ = size - 1;
+            break;
         }
-    } catch (const std::exception& e) {
-        output_ << e.what() << std::endl;
     }
-    return true;
+    dispatch_table_stale_ = false;
+}
+
+const Menu::Action* Menu::FindAction(std::string_view name) const noexcept {
+    const auto action = dispatch_table_[std::hash<std::string_view>{}(name) & dispatch_mask_];
+    return action && action->first == name ? action : nullptr;
 }
 
 }  // namespace menu
@@ -2,13 +2,25 @@
 #include <functional>
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
+
+#include "command_args.h"
 
 namespace menu {
 
 class Menu {
 public:
-    using Handler = std::function<bool(std::istream&)>;
+    using Handler = std::function<bool(CommandArgs)>;
+
+    enum class Result {
+        Continue,
+        // A handler asked to stop
+        Exit,
+        // The command is unknown or its handler threw
+        Failed,
+    };
 
     Menu(std::istream& input, std::ostream& output);
 
@@ -16,6 +28,8 @@ public:
                    Handler handler);
 
     void Run();
+    // Runs one command line; the handler may read further input from the menu's input stream
+    Result Execute(std::string_view line);
 
     void ShowInstructions() const;
 
@@ -29,12 +43,19 @@ private:
             args(std::move(_args)),
             description(std::move(_description)) {}
     };
+    using Action = std::map<std::string, ActionInfo, std::less<>>::value_type;
 
-    [[nodiscard]] bool ParseCommand(std::istream& input);
+    // Rebuilds the dispatch table after actions were added
+    void BuildDispatchTable();
+    const Action* FindAction(std::string_view name) const noexcept;
 
     std::istream& input_;
     std::ostream& output_;
-    std::map<std::string, ActionInfo> actions_;
+    std::map<std::string, ActionInfo, std::less<>> actions_;
+    // Open addressing without collisions: each action owns the slot its name hashes to
+    std::vector<const Action*> dispatch_table_;
+    size_t dispatch_mask_ = 0;
+    bool dispatch_table_stale_ = true;
 };
 
-}  // namespace menu
\ No newline at end of file
+}  // namespace menu
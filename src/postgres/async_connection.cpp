@@ -0,0 +1,160 @@
+#include "async_connection.h"
+
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <charconv>
+
+#include "statements.h"
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+using WaitType = net::posix::stream_descriptor::wait_type;
+
+// The socket may change while connecting, so every poll waits on a freshly borrowed descriptor
+net::awaitable<void> WaitConnecting(PGconn* connection, WaitType wait_type) {
+    net::posix::stream_descriptor socket{co_await net::this_coro::executor, PQsocket(connection)};
+    try {
+        co_await socket.async_wait(wait_type, net::use_awaitable);
+    } catch (...) {
+        socket.release();
+        throw;
+    }
+    socket.release();
+}
+
+}  // namespace
+
+int AsyncResult::Column(const char* column) const {
+    int index = PQfnumber(result_.get(), column);
+    if (index < 0)
+        throw AsyncError("Unknown column "s + column);
+    return index;
+}
+
+bool AsyncResult::IsNull(int row, const char* column) const {
+    return PQgetisnull(result_.get(), row, Column(column)) != 0;
+}
+
+std::string_view AsyncResult::Get(int row, const char* column) const {
+    int index = Column(column);
+    return {PQgetvalue(result_.get(), row, index),
+            static_cast<size_t>(PQgetlength(result_.get(), row, index))};
+}
+
+int AsyncResult::GetInt(int row, const char* column) const {
+    auto text = Get(row, column);
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size())
+        throw AsyncError("Column "s + column + " is not an integer");
+    return value;
+}
+
+net::awaitable<std::unique_ptr<AsyncConnection>> AsyncConnection::Connect(std::string db_url) {
+    ConnectionPtr connection{PQconnectStart(db_url.c_str()), &PQfinish};
+    if (!connection)
+        throw AsyncError("Failed to allocate a connection");
+    if (PQstatus(connection.get()) == CONNECTION_BAD)
+        throw AsyncError(PQerrorMessage(connection.get()));
+
+    auto status = PGRES_POLLING_WRITING;
+    while (status != PGRES_POLLING_OK) {
+        if (status == PGRES_POLLING_FAILED)
+            throw AsyncError(PQerrorMessage(connection.get()));
+        co_await WaitConnecting(connection.get(),
+                                status == PGRES_POLLING_READING ? WaitType::wait_read : WaitType::wait_write);
+        status = PQconnectPoll(connection.get());
+    }
+    if (PQsetnonblocking(connection.get(), 1) != 0)
+        throw AsyncError(PQerrorMessage(connection.get()));
+
+    std::unique_ptr<AsyncConnection> result{
+            new AsyncConnection(co_await net::this_coro::executor, std::move(connection))};
+    for (const auto& info: STATEMENTS) {
+        if (!PQsendPrepare(result->connection_.get(), info.name, info.sql, 0, nullptr))
+            throw AsyncError(PQerrorMessage(result->connection_.get()));
+        co_await result->Flush();
+        co_await result->ReadResult();
+    }
+    co_return result;
+}
+
+AsyncConnection::AsyncConnection(const net::any_io_executor& executor, ConnectionPtr connection)
+    : connection_{std::move(connection)}
+    , socket_{executor, PQsocket(connection_.get())} {
+}
+
+AsyncConnection::~AsyncConnection() {
+    socket_.release();
+}
+
+net::awaitable<AsyncResult> AsyncConnection::Exec(const char* sql) {
+    if (!PQsendQuery(connection_.get(), sql))
+        throw AsyncError(PQerrorMessage(connection_.get()));
+    co_await Flush();
+    co_return co_await ReadResult();
+}
+
+net::awaitable<AsyncResult> AsyncConnection::ExecPrepared(const char* name, const AsyncParams& params) {
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const auto& param: params)
+        values.push_back(param.has_value() ? param->c_str() : nullptr);
+    if (!PQsendQueryPrepared(connection_.get(), name, static_cast<int>(values.size()), values.data(),
+                             nullptr, nullptr, 0))
+        throw AsyncError(PQerrorMessage(connection_.get()));
+    co_await Flush();
+    co_return co_await ReadResult();
+}
+
+net::awaitable<void> AsyncConnection::Flush() {
+    using namespace net::experimental::awaitable_operators;
+    while (true) {
+        int res = PQflush(connection_.get());
+        if (res == 0)
+            co_return;
+        if (res < 0)
+            throw AsyncError(PQerrorMessage(connection_.get()));
+        // The server may stop reading our input until we read its output, so whatever it sends
+        // while we wait to write is consumed before flushing again
+        auto ready = co_await (socket_.async_wait(WaitType::wait_read, net::use_awaitable) ||
+                               socket_.async_wait(WaitType::wait_write, net::use_awaitable));
+        if (ready.index() == 0 && !PQconsumeInput(connection_.get()))
+            throw AsyncError(PQerrorMessage(connection_.get()));
+    }
+}
+
+net::awaitable<AsyncResult> AsyncConnection::ReadResult() {
+    std::optional<AsyncResult> result;
+    std::string error;
+    // Results must be drained until libpq returns null, even after an error
+    while (true) {
+        while (PQisBusy(connection_.get())) {
+            co_await socket_.async_wait(WaitType::wait_read, net::use_awaitable);
+            if (!PQconsumeInput(connection_.get()))
+                throw AsyncError(PQerrorMessage(connection_.get()));
+        }
+        PGresult* next = PQgetResult(connection_.get());
+        if (next == nullptr)
+            break;
+        AsyncResult current{next};
+        auto status = PQresultStatus(next);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK && error.empty())
+            error = PQresultErrorMessage(next);
+        if (!result.has_value())
+            result.emplace(std::move(current));
+    }
+    if (!error.empty())
+        throw AsyncError(error);
+    if (!result.has_value())
+        throw AsyncError("No result returned");
+    co_return std::move(*result);
+}
+
+}  // namespace postgres
@@ -0,0 +1,81 @@
+#pragma once
+#include <libpq-fe.h>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace postgres {
+
+namespace net = boost::asio;
+
+class AsyncError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class AsyncResult {
+public:
+    explicit AsyncResult(PGresult* result) noexcept
+        : result_{result, &PQclear} {
+    }
+
+    int Size() const noexcept {
+        return PQntuples(result_.get());
+    }
+
+    bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    bool IsNull(int row, const char* column) const;
+    std::string_view Get(int row, const char* column) const;
+
+    std::string GetString(int row, const char* column) const {
+        return std::string{Get(row, column)};
+    }
+    int GetInt(int row, const char* column) const;
+
+private:
+    int Column(const char* column) const;
+
+    std::unique_ptr<PGresult, decltype(&PQclear)> result_;
+};
+
+using AsyncParams = std::vector<std::optional<std::string>>;
+
+// A libpq connection in non-blocking mode whose socket is driven by an Asio executor.
+// One statement runs at a time per connection; use several connections to keep many queries in flight.
+class AsyncConnection {
+public:
+    // Opens the connection and prepares the statement catalog on it
+    static net::awaitable<std::unique_ptr<AsyncConnection>> Connect(std::string db_url);
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+    ~AsyncConnection();
+
+    net::awaitable<AsyncResult> Exec(const char* sql);
+    net::awaitable<AsyncResult> ExecPrepared(const char* name, const AsyncParams& params);
+
+private:
+    using ConnectionPtr = std::unique_ptr<PGconn, decltype(&PQfinish)>;
+
+    AsyncConnection(const net::any_io_executor& executor, ConnectionPtr connection);
+
+    net::awaitable<void> Flush();
+    net::awaitable<AsyncResult> ReadResult();
+
+    ConnectionPtr connection_;
+    // Borrows the libpq socket; released rather than closed on destruction
+    net::posix::stream_descriptor socket_;
+};
+
+}  // namespace postgres
@@ -0,0 +1,207 @@
+#include "async_unit_of_work.h"
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "rows.h"
+
+namespace postgres {
+
+namespace detail {
+
+std::optional<std::string> ToParam(const std::vector<std::string>& values) {
+    std::string literal = "{";
+    for (const auto& value: values) {
+        if (literal.size() > 1)
+            literal += ',';
+        literal += '"';
+        for (char c: value) {
+            if (c == '"' || c == '\\')
+                literal += '\\';
+            literal += c;
+        }
+        literal += '"';
+    }
+    literal += '}';
+    return literal;
+}
+
+}  // namespace detail
+
+namespace {
+
+template <typename Id>
+Id IdFromResult(const AsyncResult& res, int row, const char* column) {
+    return Id{util::detail::UUIDFromString(res.Get(row, column))};
+}
+
+std::vector<items::AuthorInfo> AuthorsFromResult(const AsyncResult& res) {
+    std::vector<items::AuthorInfo> authors;
+    authors.reserve(res.Size());
+    for (int row = 0; row < res.Size(); ++row)
+        authors.emplace_back(IdFromResult<domain::AuthorId>(res, row, "id"), res.GetString(row, "name"));
+    return authors;
+}
+
+// One row of an AsyncResult, as read by detail::BookFromRow
+struct AsyncRow {
+    const AsyncResult& res;
+    int row;
+
+    std::string GetString(const char* column) const {
+        return res.GetString(row, column);
+    }
+    int GetInt(const char* column) const {
+        return res.GetInt(row, column);
+    }
+    template <typename Id>
+    Id GetId(const char* column) const {
+        return IdFromResult<Id>(res, row, column);
+    }
+};
+
+std::vector<items::BookInfo> BooksFromResult(const AsyncResult& res) {
+    std::vector<items::BookInfo> books;
+    books.reserve(res.Size());
+    for (int row = 0; row < res.Size(); ++row)
+        books.push_back(detail::BookFromRow(AsyncRow{res, row}));
+    return books;
+}
+
+std::optional<items::AuthorInfo> FirstAuthor(const AsyncResult& res) {
+    if (res.Empty())
+        return std::nullopt;
+    return {{IdFromResult<domain::AuthorId>(res, 0, "id"), res.GetString(0, "name")}};
+}
+
+}  // namespace
+
+net::awaitable<void> AsyncUnitOfWork::Commit() {
+    if (in_transaction_) {
+        in_transaction_ = false;
+        co_await connection_.Exec("COMMIT;");
+    }
+}
+
+net::awaitable<void> AsyncUnitOfWork::Reset() {
+    if (in_transaction_) {
+        in_transaction_ = false;
+        co_await connection_.Exec("ROLLBACK;");
+    }
+}
+
+net::awaitable<std::optional<domain::AuthorId>> AsyncUnitOfWork::AddAuthor(const std::string& name) {
+    auto author_id = domain::AuthorId::New();
+    try {
+        co_await Exec<Statement::AddAuthor>(author_id, name);
+    } catch (const AsyncError&) {
+        co_return std::nullopt;
+    }
+    co_return author_id;
+}
+
+net::awaitable<std::optional<domain::BookId>> AsyncUnitOfWork::AddBook(const std::string& title, size_t year,
+                                                                    const domain::AuthorId& author_id) {
+    auto book_id = domain::BookId::New();
+    try {
+        co_await Exec<Statement::AddBook>(book_id, author_id, title, year);
+    } catch (const AsyncError&) {
+        co_return std::nullopt;
+    }
+    co_return book_id;
+}
+
+net::awaitable<void> AsyncUnitOfWork::AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) {
+    if (!book_tags.empty())
+        co_await Exec<Statement::AddBookTags>(book_id, book_tags);
+}
+
+net::awaitable<std::vector<items::AuthorInfo>> AsyncUnitOfWork::GetAuthors() {
+    co_return AuthorsFromResult(co_await Exec<Statement::GetAuthors>());
+}
+
+net::awaitable<std::vector<items::BookInfo>> AsyncUnitOfWork::GetBooks() {
+    co_return BooksFromResult(co_await Exec<Statement::GetBooks>());
+}
+
+net::awaitable<items::Page<items::AuthorInfo>> AsyncUnitOfWork::GetAuthorsPage(
+        const std::optional<items::AuthorInfo>& after, size_t limit) {
+    auto res = after.has_value()
+            ? co_await Exec<Statement::GetAuthorsPageAfter>(after->name, after->id, limit + 1)
+            : co_await Exec<Statement::GetAuthorsFirstPage>(limit + 1);
+    co_return detail::PageFromItems(AuthorsFromResult(res), limit);
+}
+
+net::awaitable<items::Page<items::BookInfo>> AsyncUnitOfWork::GetBooksPage(
+        const std::optional<items::BookInfo>& after, size_t limit) {
+    auto res = after.has_value()
+            ? co_await Exec<Statement::GetBooksPageAfter>(after->title, after->id, limit + 1)
+            : co_await Exec<Statement::GetBooksFirstPage>(limit + 1);
+    co_return detail::PageFromItems(BooksFromResult(res), limit);
+}
+
+net::awaitable<std::vector<items::BookInfo>> AsyncUnitOfWork::GetAuthorBooks(const domain::AuthorId& author_id) {
+    co_return BooksFromResult(co_await Exec<Statement::GetAuthorBooks>(author_id));
+}
+
+net::awaitable<std::optional<items::AuthorInfo>> AsyncUnitOfWork::FindAuthorByName(const std::string& author_name) {
+    co_return FirstAuthor(co_await Exec<Statement::FindAuthorByName>(author_name));
+}
+
+net::awaitable<std::vector<items::BookInfo>> AsyncUnitOfWork::FindBookByTitle(const std::string& book_title) {
+    co_return BooksFromResult(co_await Exec<Statement::FindBookByTitle>(book_title));
+}
+
+net::awaitable<std::vector<items::BookDetails>> AsyncUnitOfWork::FindBookDetailsByTitle(const std::string& book_title) {
+    auto res = co_await Exec<Statement::FindBookDetailsByTitle>(book_title);
+    auto books = BooksFromResult(res);
+    std::vector<items::BookDetails> details;
+    details.reserve(books.size());
+    for (size_t i = 0; i < books.size(); ++i)
+        details.push_back({std::move(books[i]), detail::TagsFromArray(res.Get(static_cast<int>(i), "tags"))});
+    co_return details;
+}
+
+net::awaitable<std::vector<items::BookInfo>> AsyncUnitOfWork::SearchBooks(const std::string& query, size_t limit) {
+    if (query.empty())
+        co_return std::vector<items::BookInfo>{};
+    co_return BooksFromResult(co_await Exec<Statement::SearchBooks>(query, limit));
+}
+
+net::awaitable<void> AsyncUnitOfWork::DeleteAuthor(const domain::AuthorId& author_id) {
+    co_await Exec<Statement::DeleteAuthor>(author_id);
+}
+
+net::awaitable<void> AsyncUnitOfWork::EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) {
+    co_await Exec<Statement::EditAuthor>(author_id, new_author_name);
+}
+
+net::awaitable<void> AsyncUnitOfWork::DeleteBook(const domain::BookId& book_id) {
+    co_await Exec<Statement::DeleteBook>(book_id);
+}
+
+net::awaitable<void> AsyncUnitOfWork::EditBook(const items::BookInfo& book) {
+    co_await Exec<Statement::EditBook>(book.id, book.title, book.publication_year);
+}
+
+net::awaitable<std::optional<items::AuthorInfo>> AsyncUnitOfWork::GetBookAuthor(const domain::BookId& book_id) {
+    co_return FirstAuthor(co_await Exec<Statement::GetBookAuthor>(book_id));
+}
+
+net::awaitable<std::optional<items::AuthorInfo>> AsyncUnitOfWork::FindAuthorById(const domain::AuthorId& author_id) {
+    co_return FirstAuthor(co_await Exec<Statement::FindAuthorById>(author_id));
+}
+
+net::awaitable<std::vector<std::string>> AsyncUnitOfWork::GetBookTags(const domain::BookId& book_id) {
+    auto res = co_await Exec<Statement::GetBookTags>(book_id);
+    std::vector<std::string> tags;
+    tags.reserve(res.Size());
+    for (int row = 0; row < res.Size(); ++row)
+        tags.push_back(res.GetString(row, "tag"));
+    co_return tags;
+}
+
+net::awaitable<void> AsyncUnitOfWork::EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags) {
+    co_await Exec<Statement::EditBookTags>(book_id, new_tags);
+}
+
+}  // namespace postgres
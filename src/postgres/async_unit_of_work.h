@@ -0,0 +1,84 @@
+#pragma once
+#include <boost/asio/awaitable.hpp>
+
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../app/use_cases.h"
+#include "../util/tagged_uuid.h"
+#include "async_connection.h"
+#include "statements.h"
+
+namespace postgres {
+
+namespace detail {
+
+inline std::optional<std::string> ToParam(const std::string& value) {
+    return value;
+}
+
+template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+std::optional<std::string> ToParam(Integer value) {
+    return std::to_string(value);
+}
+
+template <typename Tag>
+std::optional<std::string> ToParam(const util::TaggedUUID<Tag>& id) {
+    return id.ToString();
+}
+
+// Formats a text[] literal
+std::optional<std::string> ToParam(const std::vector<std::string>& values);
+
+}  // namespace detail
+
+// Awaitable counterpart of UnitOfWorkImpl. The transaction starts with the first statement
+// and ends with Commit or Reset; the connection must outlive the unit of work.
+class AsyncUnitOfWork {
+public:
+    explicit AsyncUnitOfWork(AsyncConnection& connection): connection_{connection} {}
+
+    net::awaitable<std::optional<domain::AuthorId>> AddAuthor(const std::string& name);
+    net::awaitable<std::optional<domain::BookId>> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id);
+    net::awaitable<void> AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags);
+    net::awaitable<std::vector<items::AuthorInfo>> GetAuthors();
+    net::awaitable<std::vector<items::BookInfo>> GetBooks();
+    net::awaitable<items::Page<items::AuthorInfo>> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit);
+    net::awaitable<items::Page<items::BookInfo>> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit);
+    net::awaitable<std::vector<items::BookInfo>> GetAuthorBooks(const domain::AuthorId& author_id);
+    net::awaitable<std::optional<items::AuthorInfo>> FindAuthorByName(const std::string& author_name);
+    net::awaitable<std::vector<items::BookInfo>> FindBookByTitle(const std::string& book_title);
+    net::awaitable<std::vector<items::BookDetails>> FindBookDetailsByTitle(const std::string& book_title);
+    net::awaitable<std::vector<items::BookInfo>> SearchBooks(const std::string& query, size_t limit);
+    net::awaitable<void> DeleteAuthor(const domain::AuthorId& author_id);
+    net::awaitable<void> EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name);
+    net::awaitable<void> DeleteBook(const domain::BookId& book_id);
+    net::awaitable<void> EditBook(const items::BookInfo& book);
+    net::awaitable<std::optional<items::AuthorInfo>> GetBookAuthor(const domain::BookId& book_id);
+    net::awaitable<std::optional<items::AuthorInfo>> FindAuthorById(const domain::AuthorId& author_id);
+    net::awaitable<std::vector<std::string>> GetBookTags(const domain::BookId& book_id);
+    net::awaitable<void> EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags);
+    net::awaitable<void> Commit();
+    net::awaitable<void> Reset();
+
+private:
+    template <Statement id, typename... Args>
+    net::awaitable<AsyncResult> Exec(const Args&... args) {
+        static_assert(sizeof...(Args) == GetStatementInfo(id).arity,
+                      "Argument count does not match the prepared statement");
+        // Arguments are converted before the first suspension point
+        AsyncParams params{detail::ToParam(args)...};
+        if (!in_transaction_) {
+            co_await connection_.Exec("BEGIN;");
+            in_transaction_ = true;
+        }
+        co_return co_await connection_.ExecPrepared(GetStatementInfo(id).name, params);
+    }
+
+    AsyncConnection& connection_;
+    bool in_transaction_ = false;
+};
+
+}  // namespace postgres
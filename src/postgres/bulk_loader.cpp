@@ -0,0 +1,96 @@
+#include "bulk_loader.h"
+
+#include <pqxx/pqxx>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "statements.h"
+#include "uuid_traits.h"
+
+namespace postgres {
+
+BatchStats BulkLoader::LoadBatch(const std::vector<bulk::BookRecord>& records) {
+    BatchStats stats;
+    if (records.empty())
+        return stats;
+
+    auto connection = pool_.Acquire();
+    pqxx::work work{*connection};
+
+    // Authors not stored yet have no id until they are streamed below
+    std::unordered_map<std::string, std::optional<domain::AuthorId>> author_ids;
+    std::vector<std::string> author_names;
+    for (const auto& record: records) {
+        if (author_ids.try_emplace(record.author_name).second)
+            author_names.push_back(record.author_name);
+    }
+
+    for (auto row: ExecPrepared<Statement::FindAuthorsByNames>(work, author_names))
+        author_ids[to_string(row.at("name"))] = row.at("id").as<domain::AuthorId>();
+
+    {
+        auto stream = pqxx::stream_to::table(work, {"authors"}, {"id", "name"});
+        for (const auto& name: author_names) {
+            auto& id = author_ids[name];
+            if (id.has_value())
+                continue;
+            id = domain::AuthorId::New();
+            stream.write_values(*id, name);
+            ++stats.new_authors;
+        }
+        stream.complete();
+    }
+
+    std::vector<domain::BookId> book_ids;
+    book_ids.reserve(records.size());
+    {
+        auto stream = pqxx::stream_to::table(work, {"books"}, {"id", "author_id", "title", "publication_year"});
+        for (const auto& record: records) {
+            const auto& book_id = book_ids.emplace_back(domain::BookId::New());
+            stream.write_values(book_id, *author_ids[record.author_name], record.title, record.publication_year);
+        }
+        stream.complete();
+        stats.books = records.size();
+    }
+
+    std::unordered_map<std::string, int> tag_ids;
+    std::vector<std::string> tag_names;
+    for (const auto& record: records) {
+        for (const auto& tag: record.tags) {
+            if (tag_ids.try_emplace(tag, 0).second)
+                tag_names.push_back(tag);
+        }
+    }
+    if (!tag_names.empty()) {
+        for (auto row: ExecPrepared<Statement::EnsureTags>(work, tag_names))
+            tag_ids[to_string(row.at("name"))] = row.at("id").as<int>();
+    }
+
+    {
+        auto stream = pqxx::stream_to::table(work, {"book_tags"}, {"book_id", "tag_id"});
+        std::vector<int> record_tag_ids;
+        for (size_t i = 0; i < records.size(); ++i) {
+            // A record listing a tag twice must not violate the primary key
+            record_tag_ids.clear();
+            for (const auto& tag: records[i].tags)
+                record_tag_ids.push_back(tag_ids[tag]);
+            std::sort(record_tag_ids.begin(), record_tag_ids.end());
+            record_tag_ids.erase(std::unique(record_tag_ids.begin(), record_tag_ids.end()), record_tag_ids.end());
+            for (int tag_id: record_tag_ids) {
+                stream.write_values(book_ids[i], tag_id);
+                ++stats.tags;
+            }
+        }
+        stream.complete();
+    }
+
+    work.commit();
+    return stats;
+}
+
+}  // namespace postgres
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "../bulk/catalog_reader.h"
+#include "connection_pool.h"
+
+namespace postgres {
+
+struct BatchStats {
+    size_t new_authors = 0;
+    size_t books = 0;
+    size_t tags = 0;
+
+    size_t Rows() const noexcept {
+        return new_authors + books + tags;
+    }
+};
+
+// Loads imported records with COPY, one transaction per batch
+class BulkLoader {
+public:
+    explicit BulkLoader(ConnectionPool& pool): pool_{pool} {}
+
+    // Either the whole batch is committed or nothing is
+    BatchStats LoadBatch(const std::vector<bulk::BookRecord>& records);
+
+private:
+    ConnectionPool& pool_;
+};
+
+}  // namespace postgres
@@ -0,0 +1,89 @@
+#include "connection_pool.h"
+
+#include <pqxx/except>
+#include <pqxx/nontransaction>
+
+namespace postgres {
+
+ConnectionPool::ConnectionPool(const ConnectionPoolConfig& config, ConnectionFactory factory)
+    : config_{config}
+    , factory_{std::move(factory)} {
+    if (config_.max_size == 0 || config_.min_size > config_.max_size)
+        throw std::invalid_argument("Invalid connection pool size");
+    idle_.reserve(config_.max_size);
+    for (size_t i = 0; i < config_.min_size; ++i)
+        idle_.push_back({factory_(), Clock::now()});
+    size_ = idle_.size();
+}
+
+ConnectionPool::ConnectionWrapper ConnectionPool::Acquire() {
+    const auto deadline = Clock::now() + config_.acquire_timeout;
+    std::unique_lock lock{mutex_};
+    for (;;) {
+        if (!cond_var_.wait_until(lock, deadline, [this] {
+                return !idle_.empty() || size_ < config_.max_size;
+            })) {
+            throw ConnectionPoolTimeout("Timed out waiting for a database connection");
+        }
+        if (idle_.empty())
+            break;
+
+        auto idle = std::move(idle_.back());
+        idle_.pop_back();
+        // The check may take a round trip, so other threads are not held up meanwhile
+        lock.unlock();
+        if (IsAlive(idle))
+            return {std::move(idle.connection), *this};
+        idle.connection.reset();
+        lock.lock();
+        --size_;
+    }
+
+    ++size_;
+    lock.unlock();
+    try {
+        return {factory_(), *this};
+    } catch (...) {
+        lock.lock();
+        --size_;
+        cond_var_.notify_one();
+        throw;
+    }
+}
+
+bool ConnectionPool::IsAlive(const IdleConnection& idle) const {
+    if (!idle.connection->is_open())
+        return false;
+    // Recently used connections are trusted; the socket state alone misses drops by the server
+    if (Clock::now() - idle.idle_since < config_.validation_interval)
+        return true;
+    try {
+        pqxx::nontransaction{*idle.connection}.exec("SELECT 1");
+        return true;
+    } catch (const pqxx::failure&) {
+        return false;
+    }
+}
+
+void ConnectionPool::ReturnConnection(ConnectionPtr&& connection) noexcept {
+    {
+        std::lock_guard lock{mutex_};
+        if (connection->is_open())
+            idle_.push_back({std::move(connection), Clock::now()});
+        else
+            --size_;
+    }
+    cond_var_.notify_one();
+}
+
+size_t ConnectionPool::Size() const {
+    std::lock_guard lock{mutex_};
+    return size_;
+}
+
+size_t ConnectionPool::IdleSize() const {
+    std::lock_guard lock{mutex_};
+    return idle_.size();
+}
+
+}  // namespace postgres
@@ -0,0 +1,107 @@
+#pragma once
+#include <pqxx/connection>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace postgres {
+
+struct ConnectionPoolConfig {
+    std::string db_url;
+    size_t min_size = 1;
+    size_t max_size = 1;
+    std::chrono::milliseconds acquire_timeout{5000};
+    // Connections idle for longer are checked with a round trip before being leased
+    std::chrono::milliseconds validation_interval{1000};
+};
+
+class ConnectionPoolTimeout : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Bounded pool of connections. Leased connections return to the pool when their wrapper is destroyed
+class ConnectionPool {
+public:
+    using ConnectionPtr = std::unique_ptr<pqxx::connection>;
+    using ConnectionFactory = std::function<ConnectionPtr()>;
+
+    class ConnectionWrapper {
+    public:
+        ConnectionWrapper(ConnectionPtr&& connection, ConnectionPool& pool) noexcept
+            : connection_{std::move(connection)}
+            , pool_{&pool} {
+        }
+
+        ConnectionWrapper(const ConnectionWrapper&) = delete;
+        ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
+
+        ConnectionWrapper(ConnectionWrapper&&) = default;
+        ConnectionWrapper& operator=(ConnectionWrapper&& other) noexcept {
+            if (this != &other) {
+                Release();
+                connection_ = std::move(other.connection_);
+                pool_ = other.pool_;
+            }
+            return *this;
+        }
+
+        pqxx::connection& operator*() const& noexcept {
+            return *connection_;
+        }
+        pqxx::connection& operator*() const&& = delete;
+
+        pqxx::connection* operator->() const& noexcept {
+            return connection_.get();
+        }
+
+        void Release() noexcept {
+            if (connection_)
+                pool_->ReturnConnection(std::move(connection_));
+        }
+
+        ~ConnectionWrapper() {
+            Release();
+        }
+
+    private:
+        ConnectionPtr connection_;
+        ConnectionPool* pool_;
+    };
+
+    ConnectionPool(const ConnectionPoolConfig& config, ConnectionFactory factory);
+
+    // Waits up to acquire_timeout for a free connection, opening a new one while below max_size.
+    // Idle connections the server has dropped are discarded and replaced.
+    ConnectionWrapper Acquire();
+
+    size_t Size() const;
+    size_t IdleSize() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleConnection {
+        ConnectionPtr connection;
+        Clock::time_point idle_since;
+    };
+
+    void ReturnConnection(ConnectionPtr&& connection) noexcept;
+    bool IsAlive(const IdleConnection& idle) const;
+
+    ConnectionPoolConfig config_;
+    ConnectionFactory factory_;
+    mutable std::mutex mutex_;
+    std::condition_variable cond_var_;
+    std::vector<IdleConnection> idle_;
+    size_t size_ = 0;
+};
+
+}  // namespace postgres
@@ -0,0 +1,149 @@
+#include "migrations.h"
+
+#include <pqxx/pqxx>
+
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace postgres {
+
+using pqxx::operator"" _zv;
+
+namespace {
+
+struct Migration {
+    int version;
+    const char* description;
+    const char* sql;
+};
+
+// Migrations are append-only: never edit one that has shipped, add a new version instead
+constexpr std::array MIGRATIONS{
+    Migration{1, "initial schema", R"(
+CREATE TABLE IF NOT EXISTS authors (
+    id UUID CONSTRAINT author_id_constraint PRIMARY KEY,
+    name varchar(100) UNIQUE NOT NULL
+);
+CREATE TABLE IF NOT EXISTS books (
+    id UUID CONSTRAINT book_id_constraint PRIMARY KEY,
+    author_id UUID NOT NULL,
+    title varchar(100) NOT NULL,
+    publication_year integer NOT NULL
+);
+CREATE TABLE IF NOT EXISTS book_tags (
+    book_id UUID NOT NULL,
+    tag varchar(30)
+);
+)"},
+    Migration{2, "lookup indexes", R"(
+CREATE INDEX IF NOT EXISTS books_author_id_idx ON books (author_id);
+CREATE INDEX IF NOT EXISTS books_title_idx ON books (title);
+CREATE INDEX IF NOT EXISTS book_tags_book_id_idx ON book_tags (book_id);
+)"},
+    // Rows left behind by a failed multi-statement delete are unreachable and would block the constraints.
+    // Books go first so that the tags of the books deleted here are cleaned up as well.
+    Migration{3, "foreign keys", R"(
+DELETE FROM books WHERE NOT EXISTS (SELECT 1 FROM authors WHERE authors.id = books.author_id);
+DELETE FROM book_tags WHERE NOT EXISTS (SELECT 1 FROM books WHERE books.id = book_tags.book_id);
+ALTER TABLE books ADD CONSTRAINT books_author_id_fkey FOREIGN KEY (author_id) REFERENCES authors (id);
+ALTER TABLE book_tags ADD CONSTRAINT book_tags_book_id_fkey FOREIGN KEY (book_id) REFERENCES books (id);
+)"},
+    // Deleting an author or a book becomes one statement however many rows depend on it
+    Migration{4, "cascading deletes", R"(
+ALTER TABLE books DROP CONSTRAINT books_author_id_fkey,
+    ADD CONSTRAINT books_author_id_fkey FOREIGN KEY (author_id) REFERENCES authors (id) ON DELETE CASCADE;
+ALTER TABLE book_tags DROP CONSTRAINT book_tags_book_id_fkey,
+    ADD CONSTRAINT book_tags_book_id_fkey FOREIGN KEY (book_id) REFERENCES books (id) ON DELETE CASCADE;
+)"},
+    // Word-prefix matching goes through the tsvector index, substring and typo-tolerant matching through trigrams
+    Migration{5, "search indexes", R"(
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+CREATE INDEX IF NOT EXISTS books_title_tsv_idx ON books USING gin (to_tsvector('simple', title));
+CREATE INDEX IF NOT EXISTS books_title_trgm_idx ON books USING gin (lower(title) gin_trgm_ops);
+CREATE INDEX IF NOT EXISTS authors_name_trgm_idx ON authors USING gin (lower(name) gin_trgm_ops);
+)"},
+    // Each tag name is stored once; books refer to it by an integer id
+    Migration{6, "tag dictionary", R"(
+CREATE TABLE tags (
+    id integer GENERATED ALWAYS AS IDENTITY PRIMARY KEY,
+    name varchar(30) NOT NULL UNIQUE
+);
+INSERT INTO tags (name) SELECT DISTINCT tag FROM book_tags WHERE tag IS NOT NULL;
+ALTER TABLE book_tags RENAME TO book_tag_names;
+CREATE TABLE book_tags (
+    book_id UUID NOT NULL REFERENCES books (id) ON DELETE CASCADE,
+    tag_id integer NOT NULL REFERENCES tags (id),
+    PRIMARY KEY (book_id, tag_id)
+);
+INSERT INTO book_tags (book_id, tag_id)
+SELECT DISTINCT book_tag_names.book_id, tags.id
+FROM book_tag_names JOIN tags ON tags.name = book_tag_names.tag;
+DROP TABLE book_tag_names;
+CREATE INDEX book_tags_tag_id_idx ON book_tags (tag_id);
+)"},
+    // Matches the keyset of book selection pages, bytewise like their ORDER BY
+    Migration{7, "book page index", R"(
+CREATE INDEX books_title_c_id_idx ON books (title COLLATE "C", id);
+)"},
+};
+
+constexpr bool AreMigrationsOrdered() {
+    for (size_t i = 0; i < MIGRATIONS.size(); ++i)
+        if (MIGRATIONS[i].version != static_cast<int>(i) + 1)
+            return false;
+    return true;
+}
+
+static_assert(AreMigrationsOrdered(), "Migration versions must be consecutive starting from 1");
+
+std::optional<int> ReadSchemaVersion(pqxx::connection& connection) {
+    try {
+        pqxx::read_transaction read{connection};
+        return read.exec1("SELECT max(version) FROM schema_version;"_zv)[0].get<int>().value_or(0);
+    } catch (const pqxx::undefined_table&) {
+        return std::nullopt;
+    }
+}
+
+}  // namespace
+
+int LatestSchemaVersion() noexcept {
+    return MIGRATIONS.back().version;
+}
+
+size_t ApplyMigrations(pqxx::connection& connection, int target_version) {
+    if (target_version < 0 || target_version > LatestSchemaVersion())
+        throw std::invalid_argument("Unknown schema version " + std::to_string(target_version));
+    if (ReadSchemaVersion(connection).value_or(-1) >= target_version)
+        return 0;
+
+    pqxx::work work{connection};
+    work.exec(R"(
+CREATE TABLE IF NOT EXISTS schema_version (
+    version integer PRIMARY KEY,
+    description text NOT NULL,
+    applied_at timestamptz NOT NULL DEFAULT now()
+);
+)"_zv);
+    // Concurrent starters wait here and then see the migrations applied by the first one
+    work.exec("LOCK TABLE schema_version IN EXCLUSIVE MODE;"_zv);
+    auto current = work.exec1("SELECT max(version) FROM schema_version;"_zv)[0].get<int>().value_or(0);
+
+    size_t applied = 0;
+    for (const auto& migration: MIGRATIONS) {
+        if (migration.version <= current)
+            continue;
+        if (migration.version > target_version)
+            break;
+        work.exec(pqxx::zview{migration.sql});
+        work.exec_params("INSERT INTO schema_version (version, description) VALUES ($1, $2);"_zv,
+                         migration.version, migration.description);
+        ++applied;
+    }
+    work.commit();
+    return applied;
+}
+
+}  // namespace postgres
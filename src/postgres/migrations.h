@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+namespace pqxx {
+class connection;
+}
+
+namespace postgres {
+
+int LatestSchemaVersion() noexcept;
+
+// Brings the schema up to target_version, recording applied versions in the schema_version table.
+// An up-to-date database costs a single query. Returns the number of migrations applied.
+size_t ApplyMigrations(pqxx::connection& connection, int target_version = LatestSchemaVersion());
+
+}  // namespace postgres
@@ -1,5 +1,8 @@
 #include "postgres.h"
 
+#include "migrations.h"
+#include "rows.h"
+
 #include <pqxx/zview.hxx>
 
 namespace postgres {
@@ -7,11 +10,58 @@ namespace postgres {
 using namespace std::literals;
 using pqxx::operator"" _zv;
 
+namespace {
+
+// One row of a pqxx::result, as read by detail::BookFromRow
+struct ResultRow {
+    pqxx::row row;
+
+    std::string GetString(const char* column) const {
+        return to_string(row.at(column));
+    }
+    int GetInt(const char* column) const {
+        return row.at(column).as<int>();
+    }
+    template <typename Id>
+    Id GetId(const char* column) const {
+        return row.at(column).as<Id>();
+    }
+};
+
+std::vector<items::BookInfo> BooksFromResult(const pqxx::result& res) {
+    std::vector<items::BookInfo> books;
+    books.reserve(res.size());
+    for (auto row: res)
+        books.push_back(detail::BookFromRow(ResultRow{row}));
+    return books;
+}
+
+}  // namespace
+
+UnitOfWorkImpl::UnitOfWorkImpl(ConnectionPool::ConnectionWrapper connection, TransactionMode mode)
+    : connection_{std::move(connection)} {
+    using SnapshotTransaction = pqxx::transaction<pqxx::isolation_level::serializable, pqxx::write_policy::read_only>;
+    switch (mode) {
+        case TransactionMode::ReadWrite:
+            work_ = std::make_unique<pqxx::work>(*connection_);
+            break;
+        case TransactionMode::ReadOnly:
+            work_ = std::make_unique<pqxx::read_transaction>(*connection_);
+            break;
+        case TransactionMode::ReadOnlySnapshot:
+            work_ = std::make_unique<SnapshotTransaction>(*connection_);
+            ++round_trips_;
+            work_->exec("SET TRANSACTION DEFERRABLE;"_zv);
+            break;
+    }
+}
+
 void UnitOfWorkImpl::Commit() {
     if (work_ != nullptr) {
         work_->commit();
         work_.reset();
     }
+    connection_.Release();
 }
 
 void UnitOfWorkImpl::Reset() {
@@ -19,146 +69,150 @@ void UnitOfWorkImpl::Reset() {
        work_->abort();
        work_.reset();
    }
+   connection_.Release();
 }
 
-std::optional<std::string> UnitOfWorkImpl::AddAuthor(const std::string &name) {
+std::optional<domain::AuthorId> UnitOfWorkImpl::AddAuthor(const std::string &name) {
     try {
-        auto author_id = domain::AuthorId::New().ToString();
-        work_->exec_params(R"(INSERT INTO authors (id, name) VALUES ($1, $2);)"_zv, author_id, name);
+        auto author_id = domain::AuthorId::New();
+        Exec<Statement::AddAuthor>(author_id, name);
         return author_id;
     } catch (const std::exception& e) {
         return std::nullopt;
     }
 }
 
-std::optional<std::string> UnitOfWorkImpl::AddBook(const std::string &title, size_t year, std::string author_id) {
+std::optional<domain::BookId> UnitOfWorkImpl::AddBook(const std::string &title, size_t year, const domain::AuthorId& author_id) {
     try {
-        auto book_id = domain::BookId::New().ToString();
-        work_->exec_params(
-                R"(INSERT INTO books (id, author_id, title, publication_year) VALUES ($1, $2, $3, $4))"_zv,
-                    book_id, author_id, title, year);
+        auto book_id = domain::BookId::New();
+        Exec<Statement::AddBook>(book_id, author_id, title, year);
         return book_id;
     } catch (const std::exception& e) {
         return std::nullopt;
     }
 }
 
-void UnitOfWorkImpl::AddBookTags(const std::string &book_id, const std::vector<std::string> &book_tags) {
-    for (auto& tag: book_tags)
-        work_->exec_params(R"(INSERT INTO book_tags (book_id, tag) VALUES ($1, $2);)"_zv, book_id, tag);
+void UnitOfWorkImpl::AddBookTags(const domain::BookId& book_id, const std::vector<std::string> &book_tags) {
+    if (!book_tags.empty())
+        Exec<Statement::AddBookTags>(book_id, book_tags);
 }
 
 std::optional<items::AuthorInfo> UnitOfWorkImpl::FindAuthorByName(const std::string &author_name) {
-    auto res = work_->exec_params(R"(SELECT * FROM authors WHERE name = $1)"_zv, author_name);
+    auto res = Exec<Statement::FindAuthorByName>(author_name);
     if (res.empty())
         return std::nullopt;
     auto author = res.begin();
-    return {{to_string(author.at("id")), to_string(author.at("name"))}};
+    return {{author.at("id").as<domain::AuthorId>(), to_string(author.at("name"))}};
 }
 
 std::vector<items::BookInfo> UnitOfWorkImpl::FindBookByTitle(const std::string& book_title) {
-    std::vector<items::BookInfo> books;
-    auto res = work_->exec_params(R"(SELECT * FROM books WHERE title = $1;)"_zv, book_title);
-    for (auto row: res) {
-        auto author_id = to_string(row.at("author_id"));
-        auto res_author = work_->exec_params(R"(SELECT * FROM authors WHERE id = $1;)"_zv, author_id);
-        if (res_author.empty() || res_author.size() > 1)
-            continue;
-        auto author_name = to_string(res_author.begin().at("name"));
-        books.emplace_back(std::move(to_string(row.at("title"))),
-                           std::move(to_string(row.at("id"))),
-                           std::move(author_id),
-                           std::move(author_name),
-                           row.at("publication_year").as<int>());
-    }
-    return books;
+    return BooksFromResult(Exec<Statement::FindBookByTitle>(book_title));
+}
+
+std::vector<items::BookDetails> UnitOfWorkImpl::FindBookDetailsByTitle(const std::string& book_title) {
+    auto res = Exec<Statement::FindBookDetailsByTitle>(book_title);
+    auto books = BooksFromResult(res);
+    std::vector<items::BookDetails> details;
+    details.reserve(books.size());
+    for (size_t i = 0; i < books.size(); ++i)
+        details.push_back({std::move(books[i]), detail::TagsFromArray(res[i].at("tags").view())});
+    return details;
+}
+
+std::vector<items::BookInfo> UnitOfWorkImpl::SearchBooks(const std::string& query, size_t limit) {
+    // An empty pattern would match every book
+    if (query.empty())
+        return {};
+    return BooksFromResult(Exec<Statement::SearchBooks>(query, limit));
 }
 
 std::vector<items::AuthorInfo> UnitOfWorkImpl::GetAuthors() {
     std::vector<items::AuthorInfo> authors;
-    for (auto [id, name]: work_->query<std::string,std::string>("SELECT * FROM authors ORDER BY name;"_zv)) {
-        authors.emplace_back(std::move(id), std::move(name));
-    }
+    auto res = Exec<Statement::GetAuthors>();
+    authors.reserve(res.size());
+    for (auto row: res)
+        authors.emplace_back(row.at("id").as<domain::AuthorId>(), to_string(row.at("name")));
     return authors;
 }
 
 std::vector<items::BookInfo> UnitOfWorkImpl::GetBooks() {
-    std::vector<items::BookInfo> books;
-    auto res = work_->exec(R"(SELECT * FROM books ORDER BY title;)"_zv);
-    for (auto row: res) {
-        auto author_id = to_string(row.at("author_id"));
-        auto res_author = work_->exec_params(R"(SELECT * FROM authors WHERE id = $1;)"_zv, author_id);
-        if (res_author.empty() || res_author.size() > 1)
-            continue;
-        auto author_name = to_string(res_author.begin().at("name"));
-        books.emplace_back(std::move(to_string(row.at("title"))),
-                           std::move(to_string(row.at("id"))),
-                           std::move(author_id),
-                           std::move(author_name),
-                           row.at("publication_year").as<int>());
-    }
-    return books;
+    return BooksFromResult(Exec<Statement::GetBooks>());
 }
 
-std::vector<items::BookInfo> UnitOfWorkImpl::GetAuthorBooks(const std::string& author_id) {
-    std::vector<items::BookInfo> books;
-    auto res = work_->exec_params(R"(SELECT * FROM books WHERE author_id = $1 ORDER BY publication_year;)"_zv, author_id);
-    auto res_author = work_->exec_params(R"(SELECT * FROM authors WHERE id = $1;)"_zv, author_id);
-    if (res_author.empty() || res_author.size() > 1)
-        return books;
-    for (auto row: res) {
-        auto author_name = to_string(res_author.begin().at("name"));
-        books.emplace_back(std::move(to_string(row.at("title"))),
-                           std::move(to_string(row.at("id"))),
-                           std::move(to_string(row.at("author_id"))),
-                           std::move(author_name),
-                           row.at("publication_year").as<int>());
-    }
-    return books;
+void UnitOfWorkImpl::ForEachBook(const app::BookVisitor& visitor) {
+    // COPY cannot run a prepared statement, so the streamed listing is sent as text.
+    // Byte-wise collation matches the order the console listings always used.
+    ++round_trips_;
+    auto rows = work_->stream<std::string, domain::BookId, domain::AuthorId, std::string, int>(R"(
+SELECT books.title, books.id, books.author_id, authors.name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+ORDER BY books.title COLLATE "C", lower(authors.name) COLLATE "C"
+)"_zv);
+    for (auto [title, id, author_id, author_name, year]: rows)
+        visitor(items::BookInfo{std::move(title), id, author_id, std::move(author_name), year});
+}
+
+void UnitOfWorkImpl::ForEachBookTag(const app::BookTagVisitor& visitor) {
+    ++round_trips_;
+    auto rows = work_->stream<domain::BookId, std::string>(
+            "SELECT book_tags.book_id, tags.name FROM book_tags JOIN tags ON tags.id = book_tags.tag_id"_zv);
+    for (auto [book_id, tag]: rows)
+        visitor(book_id, std::move(tag));
 }
 
-void UnitOfWorkImpl::DeleteAuthor(const std::string &author_id) {
-    work_->exec_params(R"(DELETE FROM authors WHERE id = $1;)"_zv, author_id);
+items::Page<items::AuthorInfo> UnitOfWorkImpl::GetAuthorsPage(const std::optional<items::AuthorInfo>& after,
+                                                              size_t limit) {
+    auto res = after.has_value()
+            ? Exec<Statement::GetAuthorsPageAfter>(after->name, after->id, limit + 1)
+            : Exec<Statement::GetAuthorsFirstPage>(limit + 1);
+    std::vector<items::AuthorInfo> authors;
+    authors.reserve(res.size());
+    for (auto row: res)
+        authors.emplace_back(row.at("id").as<domain::AuthorId>(), to_string(row.at("name")));
+    return detail::PageFromItems(std::move(authors), limit);
 }
 
-void UnitOfWorkImpl::DeleteBook(const std::string &book_id) {
-    work_->exec_params(R"(DELETE FROM books WHERE id = $1;)"_zv, book_id);
+items::Page<items::BookInfo> UnitOfWorkImpl::GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) {
+    auto res = after.has_value()
+            ? Exec<Statement::GetBooksPageAfter>(after->title, after->id, limit + 1)
+            : Exec<Statement::GetBooksFirstPage>(limit + 1);
+    return detail::PageFromItems(BooksFromResult(res), limit);
 }
 
-void UnitOfWorkImpl::DeleteAuthorBooks(const std::string &author_id) {
-    auto res = work_->exec_params(R"(SELECT * FROM books WHERE author_id = $1;)"_zv, author_id);
-    for (auto row: res)
-        DeleteBookTags(to_string(row.at("id")));
-    work_->exec_params(R"(DELETE FROM books WHERE author_id = $1;)"_zv, author_id);
+std::vector<items::BookInfo> UnitOfWorkImpl::GetAuthorBooks(const domain::AuthorId& author_id) {
+    return BooksFromResult(Exec<Statement::GetAuthorBooks>(author_id));
 }
 
-void UnitOfWorkImpl::DeleteBookTags(const std::string &book_id) {
-    work_->exec_params(R"(DELETE FROM book_tags WHERE book_id = $1;)"_zv, book_id);
+void UnitOfWorkImpl::DeleteAuthor(const domain::AuthorId& author_id) {
+    Exec<Statement::DeleteAuthor>(author_id);
 }
 
-void UnitOfWorkImpl::EditAuthor(const std::string &author_id, const std::string &new_author_name) {
-    work_->exec_params(R"(UPDATE authors SET name = $2 WHERE id = $1;)"_zv, author_id, new_author_name);
+void UnitOfWorkImpl::DeleteBook(const domain::BookId& book_id) {
+    Exec<Statement::DeleteBook>(book_id);
 }
 
-std::optional<items::AuthorInfo> UnitOfWorkImpl::GetBookAuthor(const std::string &book_id) {
-    auto res = work_->exec_params(R"(SELECT * FROM books WHERE id = $1;)"_zv, book_id);
+void UnitOfWorkImpl::EditAuthor(const domain::AuthorId& author_id, const std::string &new_author_name) {
+    Exec<Statement::EditAuthor>(author_id, new_author_name);
+}
+
+std::optional<items::AuthorInfo> UnitOfWorkImpl::GetBookAuthor(const domain::BookId& book_id) {
+    auto res = Exec<Statement::GetBookAuthor>(book_id);
     if (res.empty())
         return std::nullopt;
-    auto author_id = to_string(res.begin().at("author_id"));
-    return {{std::move(author_id), "NULL"}};
+    auto author = res.begin();
+    return {{author.at("id").as<domain::AuthorId>(), to_string(author.at("name"))}};
 }
 
-std::optional<items::AuthorInfo> UnitOfWorkImpl::FindAuthorById(const std::string &author_id) {
-    auto res = work_->exec_params(R"(SELECT * FROM authors WHERE id = $1;)"_zv, author_id);
+std::optional<items::AuthorInfo> UnitOfWorkImpl::FindAuthorById(const domain::AuthorId& author_id) {
+    auto res = Exec<Statement::FindAuthorById>(author_id);
     if (res.empty())
         return std::nullopt;
     auto author = res.begin();
-    auto id = to_string(author.at("id")), name = to_string(author.at("name"));
-    return {{std::move(id), std::move(name)}};
+    return {{author.at("id").as<domain::AuthorId>(), to_string(author.at("name"))}};
 }
 
-std::vector<std::string> UnitOfWorkImpl::GetBookTags(const std::string &book_id) {
-    auto res = work_->exec_params(R"(SELECT * FROM book_tags WHERE book_id = $1;)"_zv, book_id);
+std::vector<std::string> UnitOfWorkImpl::GetBookTags(const domain::BookId& book_id) {
+    auto res = Exec<Statement::GetBookTags>(book_id);
     std::vector<std::string> tags;
     for (auto row: res)
         tags.push_back(to_string(row.at("tag")));
@@ -166,40 +220,116 @@ std::vector<std::string> UnitOfWorkImpl::GetBookTags(const std::string &book_id)
 }
 
 void UnitOfWorkImpl::EditBook(const items::BookInfo &book) {
-    work_->exec_params(R"(UPDATE books SET title = $2, publication_year = $3 WHERE id = $1;)"_zv,
-                       book.id, book.title, book.publication_year);
+    Exec<Statement::EditBook>(book.id, book.title, book.publication_year);
 }
 
-void UnitOfWorkImpl::EditBookTags(const std::string &book_id, const std::vector<std::string> &new_tags) {
-    work_->exec_params(R"(DELETE FROM book_tags WHERE book_id = $1;)"_zv, book_id);
-    for (auto& tag: new_tags)
-        work_->exec_params(R"(INSERT INTO book_tags (book_id, tag) VALUES ($1, $2);)"_zv, book_id, tag);
+void UnitOfWorkImpl::EditBookTags(const domain::BookId& book_id, const std::vector<std::string> &new_tags) {
+    Exec<Statement::EditBookTags>(book_id, new_tags);
 }
 
-Database::Database(pqxx::connection connection)
-    : connection_{std::move(connection)} {
-    pqxx::work work{connection_};
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS authors (
-    id UUID CONSTRAINT author_id_constraint PRIMARY KEY,
-    name varchar(100) UNIQUE NOT NULL
-);
-)"_zv);
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS books (
-    id UUID CONSTRAINT book_id_constraint PRIMARY KEY,
-    author_id UUID NOT NULL,
-    title varchar(100) NOT NULL,
-    publication_year integer NOT NULL
-);
-)"_zv);
-    work.exec(R"(
-CREATE TABLE IF NOT EXISTS book_tags (
-    book_id UUID NOT NULL,
-    tag varchar(30)
-);
-)"_zv);
-    work.commit();
+std::unique_ptr<app::UnitOfWork>& UnitOfWorkFactoryImpl::GetUnitOfWork() {
+    const auto thread_id = std::this_thread::get_id();
+    std::unique_ptr<app::UnitOfWork> read_only;
+    {
+        std::lock_guard lock{mutex_};
+        if (auto it = units_of_work_.find(thread_id); it != units_of_work_.end()) {
+            if (it->second.read_write != nullptr)
+                return it->second.read_write;
+            // Without a replica both units lease from one pool; holding two leases per thread deadlocks
+            // a small pool, so the reads end here and their connection goes back for the writes
+            if (&read_pool_ == &pool_)
+                read_only = std::move(it->second.read_only);
+        }
+    }
+    if (read_only != nullptr) {
+        read_only->Commit();
+        read_only.reset();
+    }
+    // Leasing may block on a busy pool, so it happens outside the lock
+    auto unit_of_work = Decorate(std::make_unique<UnitOfWorkImpl>(pool_.Acquire()), {});
+    std::lock_guard lock{mutex_};
+    auto& slot = units_of_work_[thread_id].read_write;
+    slot = std::move(unit_of_work);
+    return slot;
+}
+
+std::unique_ptr<app::UnitOfWork>& UnitOfWorkFactoryImpl::GetReadOnlyUnitOfWork() {
+    const auto thread_id = std::this_thread::get_id();
+    {
+        std::lock_guard lock{mutex_};
+        if (auto it = units_of_work_.find(thread_id); it != units_of_work_.end()) {
+            // Reads inside a write transaction must see its uncommitted changes
+            if (it->second.read_write != nullptr)
+                return it->second.read_write;
+            if (it->second.read_only != nullptr)
+                return it->second.read_only;
+        }
+    }
+    const app::UnitOfWorkTraits traits{
+            .read_only = true,
+            .source = &read_pool_ == &pool_ ? app::ReadSource::Primary : app::ReadSource::Replica};
+    auto unit_of_work = Decorate(std::make_unique<UnitOfWorkImpl>(read_pool_.Acquire(), read_mode_), traits);
+    std::lock_guard lock{mutex_};
+    auto& slot = units_of_work_[thread_id].read_only;
+    slot = std::move(unit_of_work);
+    return slot;
+}
+
+std::unique_ptr<app::UnitOfWork> UnitOfWorkFactoryImpl::Decorate(std::unique_ptr<app::UnitOfWork> unit_of_work,
+                                                                 const app::UnitOfWorkTraits& traits) const {
+    return decorator_ ? decorator_(std::move(unit_of_work), traits) : std::move(unit_of_work);
+}
+
+UnitOfWorkFactoryImpl::ThreadUnits UnitOfWorkFactoryImpl::TakeUnits() {
+    ThreadUnits units;
+    std::lock_guard lock{mutex_};
+    if (auto it = units_of_work_.find(std::this_thread::get_id()); it != units_of_work_.end()) {
+        units = std::move(it->second);
+        units_of_work_.erase(it);
+    }
+    return units;
+}
+
+void UnitOfWorkFactoryImpl::CommitUnitOfWork() {
+    auto units = TakeUnits();
+    if (units.read_write != nullptr)
+        units.read_write->Commit();
+    if (units.read_only != nullptr)
+        units.read_only->Commit();
+}
+
+void UnitOfWorkFactoryImpl::ResetUnitOfWork() {
+    auto units = TakeUnits();
+    if (units.read_write != nullptr)
+        units.read_write->Reset();
+    if (units.read_only != nullptr)
+        units.read_only->Reset();
+}
+
+void UnitOfWorkFactoryImpl::DeleteUnitOfWork() {
+    TakeUnits();
+}
+
+namespace {
+
+std::unique_ptr<ConnectionPool> MakePool(const ConnectionPoolConfig& config) {
+    return std::make_unique<ConnectionPool>(config, [db_url = config.db_url] {
+        auto connection = std::make_unique<pqxx::connection>(db_url);
+        PrepareStatements(*connection);
+        return connection;
+    });
+}
+
+}  // namespace
+
+Database::Database(const ConnectionPoolConfig& config, const std::optional<ConnectionPoolConfig>& replica_config) {
+    pqxx::connection connection{config.db_url};
+    ApplyMigrations(connection);
+
+    pool_ = MakePool(config);
+    // The replica receives the schema through replication
+    if (replica_config.has_value())
+        replica_pool_ = MakePool(*replica_config);
 }
 
-}  // namespace postgres
\ No newline at end of file
+}  // namespace postgres
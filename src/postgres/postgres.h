@@ -6,64 +6,122 @@
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../app/use_cases.h"
+#include "connection_pool.h"
+#include "statements.h"
+#include "uuid_traits.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace postgres {
 
+enum class TransactionMode {
+    ReadWrite,
+    ReadOnly,
+    // Serializable read-only deferrable: a consistent snapshot that never causes serialization failures
+    ReadOnlySnapshot
+};
+
 class UnitOfWorkImpl : public app::UnitOfWork {
 public:
-    explicit UnitOfWorkImpl(pqxx::connection& connection): connection_{connection} {
-        work_ = std::make_unique<pqxx::work>(connection_);
-    }
-    std::optional<std::string> AddAuthor(const std::string& name) override;
-    std::optional<std::string> AddBook(const std::string& title, size_t year, std::string author_id) override;
-    void AddBookTags(const std::string& book_id, const std::vector<std::string>& book_tags) override;
+    explicit UnitOfWorkImpl(ConnectionPool::ConnectionWrapper connection,
+                            TransactionMode mode = TransactionMode::ReadWrite);
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override;
+    std::optional<domain::BookId> AddBook(const std::string& title, size_t year, const domain::AuthorId& author_id) override;
+    void AddBookTags(const domain::BookId& book_id, const std::vector<std::string>& book_tags) override;
     std::vector<items::AuthorInfo> GetAuthors() override;
     std::vector<items::BookInfo> GetBooks() override;
-    std::vector<items::BookInfo> GetAuthorBooks(const std::string& author_id) override;
+    void ForEachBook(const app::BookVisitor& visitor) override;
+    void ForEachBookTag(const app::BookTagVisitor& visitor) override;
+    items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>& after, size_t limit) override;
+    items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>& after, size_t limit) override;
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) override;
     std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) override;
     std::vector<items::BookInfo> FindBookByTitle(const std::string& book_title) override;
-    void DeleteAuthor(const std::string& author_id) override;
-    void DeleteAuthorBooks(const std::string& author_id) override;
-    void DeleteBookTags(const std::string& book_id) override;
-    void EditAuthor(const std::string& author_id, const std::string& new_author_name) override;
-    void DeleteBook(const std::string& book_id) override;
+    std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string& book_title) override;
+    std::vector<items::BookInfo> SearchBooks(const std::string& query, size_t limit) override;
+    void DeleteAuthor(const domain::AuthorId& author_id) override;
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override;
+    void DeleteBook(const domain::BookId& book_id) override;
     void EditBook(const items::BookInfo& book) override;
-    std::optional<items::AuthorInfo> GetBookAuthor(const std::string& book_id) override;
-    std::optional<items::AuthorInfo> FindAuthorById(const std::string& author_id) override;
-    std::vector<std::string> GetBookTags(const std::string& book_id) override;
-    void EditBookTags(const std::string& book_id, const std::vector<std::string>& new_tags_str) override;
+    std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId& book_id) override;
+    std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) override;
+    std::vector<std::string> GetBookTags(const domain::BookId& book_id) override;
+    void EditBookTags(const domain::BookId& book_id, const std::vector<std::string>& new_tags_str) override;
     void Commit() override;
     void Reset() override;
+
+    // Number of statements sent to the server by this unit of work
+    size_t GetRoundTrips() const noexcept {
+        return round_trips_;
+    }
 private:
-    pqxx::connection& connection_;
-    std::unique_ptr<pqxx::work> work_;
+    template <Statement id, typename... Args>
+    pqxx::result Exec(Args&&... args) {
+        ++round_trips_;
+        return ExecPrepared<id>(*work_, detail::AsParam(args)...);
+    }
+
+    ConnectionPool::ConnectionWrapper connection_;
+    std::unique_ptr<pqxx::transaction_base> work_;
+    size_t round_trips_ = 0;
 };
 
+// Each thread gets its own units of work holding connections leased from the pools.
+// Read-only units come from the replica pool when one is configured; otherwise a thread holds at
+// most one lease, and its read-only unit ends when it asks for a read-write one.
 class UnitOfWorkFactoryImpl: public app::UnitOfWorkFactory {
 public:
-    explicit UnitOfWorkFactoryImpl(pqxx::connection& connection): connection_{connection}  {}
-    std::unique_ptr<app::UnitOfWork>& GetUnitOfWork() override {
-        if (unit_of_work_ == nullptr)
-            unit_of_work_ = std::make_unique<UnitOfWorkImpl>(connection_);
-        return unit_of_work_;
+    explicit UnitOfWorkFactoryImpl(ConnectionPool& pool, ConnectionPool* replica_pool = nullptr,
+                                   bool snapshot_reads = false)
+        : pool_{pool}
+        , read_pool_{replica_pool != nullptr ? *replica_pool : pool}
+        , read_mode_{snapshot_reads ? TransactionMode::ReadOnlySnapshot : TransactionMode::ReadOnly} {
     }
-    void DeleteUnitOfWork() override {
-        unit_of_work_.reset();
+    std::unique_ptr<app::UnitOfWork>& GetUnitOfWork() override;
+    std::unique_ptr<app::UnitOfWork>& GetReadOnlyUnitOfWork() override;
+    void CommitUnitOfWork() override;
+    void ResetUnitOfWork() override;
+    void DeleteUnitOfWork() override;
+
+    // Applied to every unit of work created afterwards
+    void SetDecorator(app::UnitOfWorkDecorator decorator) {
+        decorator_ = std::move(decorator);
     }
 private:
-    pqxx::connection& connection_;
-    std::unique_ptr<app::UnitOfWork> unit_of_work_ = nullptr;
+    struct ThreadUnits {
+        std::unique_ptr<app::UnitOfWork> read_write;
+        std::unique_ptr<app::UnitOfWork> read_only;
+    };
+
+    ThreadUnits TakeUnits();
+    std::unique_ptr<app::UnitOfWork> Decorate(std::unique_ptr<app::UnitOfWork> unit_of_work,
+                                              const app::UnitOfWorkTraits& traits) const;
+
+    ConnectionPool& pool_;
+    ConnectionPool& read_pool_;
+    TransactionMode read_mode_;
+    app::UnitOfWorkDecorator decorator_;
+    std::mutex mutex_;
+    std::unordered_map<std::thread::id, ThreadUnits> units_of_work_;
 };
 
 class Database {
 public:
-    explicit Database(pqxx::connection connection);
-    pqxx::connection& GetConnection() {
-        return connection_;
+    explicit Database(const ConnectionPoolConfig& config,
+                      const std::optional<ConnectionPoolConfig>& replica_config = std::nullopt);
+    ConnectionPool& GetPool() {
+        return *pool_;
+    }
+    // Null when reads are served by the primary
+    ConnectionPool* GetReplicaPool() {
+        return replica_pool_.get();
     }
 
 private:
-    pqxx::connection connection_;
+    std::unique_ptr<ConnectionPool> pool_;
+    std::unique_ptr<ConnectionPool> replica_pool_;
 };
 
-}  // namespace postgres
\ No newline at end of file
+}  // namespace postgres
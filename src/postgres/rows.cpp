@@ -0,0 +1,34 @@
+#include "rows.h"
+
+namespace postgres {
+namespace detail {
+
+std::vector<std::string> TagsFromArray(std::string_view literal) {
+    std::vector<std::string> tags;
+    if (literal.size() < 2)
+        return tags;
+    literal = literal.substr(1, literal.size() - 2);
+    size_t pos = 0;
+    while (pos < literal.size()) {
+        std::string tag;
+        bool quoted = literal[pos] == '"';
+        if (quoted) {
+            for (++pos; pos < literal.size() && literal[pos] != '"'; ++pos) {
+                if (literal[pos] == '\\')
+                    ++pos;
+                tag += literal[pos];
+            }
+            ++pos;
+        } else {
+            for (; pos < literal.size() && literal[pos] != ','; ++pos)
+                tag += literal[pos];
+        }
+        if (quoted || tag != "NULL")
+            tags.push_back(std::move(tag));
+        ++pos;
+    }
+    return tags;
+}
+
+}  // namespace detail
+}  // namespace postgres
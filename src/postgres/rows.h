@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../app/use_cases.h"
+
+namespace postgres {
+namespace detail {
+
+// Maps a row of any book query to a BookInfo. Row reads a named column of one result row through
+// GetString, GetInt and GetId<Id>, so the blocking and the async unit of work share the columns.
+template <typename Row>
+items::BookInfo BookFromRow(const Row& row) {
+    return {row.GetString("title"), row.template GetId<domain::BookId>("id"),
+            row.template GetId<domain::AuthorId>("author_id"), row.GetString("author_name"),
+            row.GetInt("publication_year")};
+}
+
+// Parses a one-dimensional text[] literal such as {a,"b c",NULL}, skipping NULLs
+std::vector<std::string> TagsFromArray(std::string_view literal);
+
+// Pages are fetched with one extra row to learn whether another page follows
+template <typename Item>
+items::Page<Item> PageFromItems(std::vector<Item>&& rows, size_t limit) {
+    items::Page<Item> page{std::move(rows)};
+    if (page.items.size() > limit) {
+        page.items.erase(page.items.begin() + limit, page.items.end());
+        page.has_more = true;
+    }
+    return page;
+}
+
+}  // namespace detail
+}  // namespace postgres
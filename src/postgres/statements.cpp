@@ -0,0 +1,12 @@
+#include "statements.h"
+
+#include <pqxx/connection>
+
+namespace postgres {
+
+void PrepareStatements(pqxx::connection& connection) {
+    for (const auto& info: STATEMENTS)
+        connection.prepare(info.name, info.sql);
+}
+
+}  // namespace postgres
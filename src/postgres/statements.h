@@ -0,0 +1,274 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace pqxx {
+class connection;
+}
+
+namespace postgres {
+
+// Every statement UnitOfWorkImpl sends to the server. Statements are prepared once per
+// connection and executed by name, so the server parses and plans each of them only once.
+enum class Statement {
+    AddAuthor,
+    AddBook,
+    AddBookTags,
+    FindAuthorByName,
+    FindAuthorById,
+    FindBookByTitle,
+    GetAuthors,
+    GetBooks,
+    GetAuthorBooks,
+    GetBookAuthor,
+    GetBookTags,
+    EditAuthor,
+    EditBook,
+    DeleteAuthor,
+    DeleteBook,
+    EditBookTags,
+    FindAuthorsByNames,
+    GetAuthorsFirstPage,
+    GetAuthorsPageAfter,
+    GetBooksFirstPage,
+    GetBooksPageAfter,
+    FindBookDetailsByTitle,
+    SearchBooks,
+    EnsureTags,
+    Count
+};
+
+struct StatementInfo {
+    Statement id;
+    const char* name;
+    const char* sql;
+    size_t arity;
+};
+
+namespace detail {
+
+// Concatenates string literals at compile time so that statements can share SQL fragments
+template <size_t... Sizes>
+constexpr auto JoinSql(const char (&... parts)[Sizes]) {
+    std::array<char, (Sizes + ...) - sizeof...(Sizes) + 1> sql{};
+    auto out = sql.begin();
+    ((out = std::copy_n(parts, Sizes - 1, out)), ...);
+    return sql;
+}
+
+// Follows an "input" CTE of distinct tag names and yields their dictionary ids as "tag_ids",
+// adding the missing names first. A name inserted concurrently by another transaction hits the
+// conflict branch, which still returns its id. Names inserted here are not visible to the other
+// reads of the statement, hence the union.
+inline constexpr char TAG_IDS_CTE[] = R"(
+inserted AS (
+    INSERT INTO tags (name)
+    SELECT name FROM input WHERE NOT EXISTS (SELECT 1 FROM tags WHERE tags.name = input.name)
+    ON CONFLICT (name) DO UPDATE SET name = EXCLUDED.name
+    RETURNING id, name
+),
+tag_ids AS (
+    SELECT id, name FROM inserted
+    UNION
+    SELECT tags.id, tags.name FROM tags JOIN input ON input.name = tags.name
+))";
+
+inline constexpr auto ADD_BOOK_TAGS_SQL = JoinSql(R"(
+WITH input AS (
+    SELECT DISTINCT unnest($2::varchar[]) AS name
+),)", TAG_IDS_CTE, R"(
+INSERT INTO book_tags (book_id, tag_id)
+SELECT $1::uuid, id FROM tag_ids
+ON CONFLICT DO NOTHING;
+)");
+
+inline constexpr auto EDIT_BOOK_TAGS_SQL = JoinSql(R"(
+WITH input AS (
+    SELECT DISTINCT unnest($2::varchar[]) AS name
+),)", TAG_IDS_CTE, R"(,
+removed AS (
+    DELETE FROM book_tags WHERE book_id = $1::uuid AND tag_id NOT IN (SELECT id FROM tag_ids)
+)
+INSERT INTO book_tags (book_id, tag_id)
+SELECT $1::uuid, id FROM tag_ids
+ON CONFLICT DO NOTHING;
+)");
+
+inline constexpr auto ENSURE_TAGS_SQL = JoinSql(R"(
+WITH input AS (
+    SELECT DISTINCT unnest($1::varchar[]) AS name
+),)", TAG_IDS_CTE, R"(
+SELECT id, name FROM tag_ids;
+)");
+
+}  // namespace detail
+
+inline constexpr std::array<StatementInfo, static_cast<size_t>(Statement::Count)> STATEMENTS{{
+    {Statement::AddAuthor, "add_author",
+     R"(INSERT INTO authors (id, name) VALUES ($1, $2);)", 2},
+    {Statement::AddBook, "add_book",
+     R"(INSERT INTO books (id, author_id, title, publication_year) VALUES ($1, $2, $3, $4);)", 4},
+    {Statement::AddBookTags, "add_book_tags", detail::ADD_BOOK_TAGS_SQL.data(), 2},
+    {Statement::FindAuthorByName, "find_author_by_name",
+     R"(SELECT id, name FROM authors WHERE name = $1;)", 1},
+    {Statement::FindAuthorById, "find_author_by_id",
+     R"(SELECT id, name FROM authors WHERE id = $1;)", 1},
+    {Statement::FindBookByTitle, "find_book_by_title", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+WHERE books.title = $1;
+)", 1},
+    {Statement::GetAuthors, "get_authors",
+     R"(SELECT id, name FROM authors ORDER BY name;)", 0},
+    {Statement::GetBooks, "get_books", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+ORDER BY books.title;
+)", 0},
+    {Statement::GetAuthorBooks, "get_author_books", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+WHERE books.author_id = $1
+ORDER BY books.publication_year;
+)", 1},
+    {Statement::GetBookAuthor, "get_book_author", R"(
+SELECT authors.id, authors.name
+FROM books JOIN authors ON authors.id = books.author_id
+WHERE books.id = $1;
+)", 1},
+    {Statement::GetBookTags, "get_book_tags", R"(
+SELECT tags.name AS tag
+FROM book_tags JOIN tags ON tags.id = book_tags.tag_id
+WHERE book_tags.book_id = $1;
+)", 1},
+    {Statement::EditAuthor, "edit_author",
+     R"(UPDATE authors SET name = $2 WHERE id = $1;)", 2},
+    {Statement::EditBook, "edit_book",
+     R"(UPDATE books SET title = $2, publication_year = $3 WHERE id = $1;)", 3},
+    {Statement::DeleteAuthor, "delete_author",
+     R"(DELETE FROM authors WHERE id = $1;)", 1},
+    {Statement::DeleteBook, "delete_book",
+     R"(DELETE FROM books WHERE id = $1;)", 1},
+    // Only tags missing from $2 are deleted and only tags not yet stored are inserted
+    {Statement::EditBookTags, "edit_book_tags", detail::EDIT_BOOK_TAGS_SQL.data(), 2},
+    {Statement::FindAuthorsByNames, "find_authors_by_names",
+     R"(SELECT id, name FROM authors WHERE name = ANY($1::varchar[]);)", 1},
+    // Keyset pages: the row after the cursor is found through the sort order, not by skipping rows
+    {Statement::GetAuthorsFirstPage, "get_authors_first_page",
+     R"(SELECT id, name FROM authors ORDER BY name, id LIMIT $1;)", 1},
+    {Statement::GetAuthorsPageAfter, "get_authors_page_after",
+     R"(SELECT id, name FROM authors WHERE (name, id) > ($1, $2::uuid) ORDER BY name, id LIMIT $3;)", 3},
+    // Book pages walk books_title_c_id_idx and join each row's author, so a page costs its own rows only
+    {Statement::GetBooksFirstPage, "get_books_first_page", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+ORDER BY books.title COLLATE "C", books.id
+LIMIT $1;
+)", 1},
+    {Statement::GetBooksPageAfter, "get_books_page_after", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM books JOIN authors ON authors.id = books.author_id
+WHERE (books.title COLLATE "C", books.id) > ($1::varchar COLLATE "C", $2::uuid)
+ORDER BY books.title COLLATE "C", books.id
+LIMIT $3;
+)", 3},
+    // Book, author and tags of every match in a single round trip
+    {Statement::FindBookDetailsByTitle, "find_book_details_by_title", R"(
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year,
+    COALESCE(array_agg(tags.name ORDER BY tags.name) FILTER (WHERE tags.name IS NOT NULL), '{}') AS tags
+FROM books
+JOIN authors ON authors.id = books.author_id
+LEFT JOIN book_tags ON book_tags.book_id = books.id
+LEFT JOIN tags ON tags.id = book_tags.tag_id
+WHERE books.title = $1
+GROUP BY books.id, authors.name;
+)", 1},
+    // Books whose title has words starting with the query words, whose title or author contains
+    // the query, or whose title or author is close to it; best matches first
+    {Statement::SearchBooks, "search_books", R"(
+WITH query AS (
+    SELECT lower($1::varchar) AS needle,
+        '%' || replace(replace(replace(lower($1::varchar), '\', '\\'), '%', '\%'), '_', '\_') || '%' AS pattern,
+        COALESCE(to_tsquery('simple', (
+            SELECT string_agg(word || ':*', ' & ')
+            FROM regexp_split_to_table(lower($1::varchar), '\W+') AS word
+            WHERE word <> ''
+        )), ''::tsquery) AS prefix
+),
+matches AS (
+    SELECT books.id FROM books, query
+    WHERE to_tsvector('simple', books.title) @@ query.prefix
+        OR lower(books.title) LIKE query.pattern
+        OR query.needle <% lower(books.title)
+    UNION
+    SELECT books.id FROM authors JOIN books ON books.author_id = authors.id, query
+    WHERE lower(authors.name) LIKE query.pattern
+        OR query.needle <% lower(authors.name)
+)
+SELECT books.id, books.title, books.author_id, authors.name AS author_name, books.publication_year
+FROM matches
+JOIN books ON books.id = matches.id
+JOIN authors ON authors.id = books.author_id
+CROSS JOIN query
+ORDER BY ts_rank(to_tsvector('simple', books.title), query.prefix)
+        + word_similarity(query.needle, lower(books.title))
+        + word_similarity(query.needle, lower(authors.name)) DESC,
+    books.title, books.id
+LIMIT $2;
+)", 2},
+    // Dictionary ids of the given tag names, adding the missing ones
+    {Statement::EnsureTags, "ensure_tags", detail::ENSURE_TAGS_SQL.data(), 1},
+}};
+
+constexpr const StatementInfo& GetStatementInfo(Statement id) {
+    return STATEMENTS[static_cast<size_t>(id)];
+}
+
+namespace detail {
+
+// Highest $N placeholder used in the statement text
+constexpr size_t CountParams(std::string_view sql) {
+    size_t max_param = 0;
+    for (size_t i = 0; i < sql.size(); ++i) {
+        if (sql[i] != '$')
+            continue;
+        size_t param = 0;
+        for (size_t j = i + 1; j < sql.size() && sql[j] >= '0' && sql[j] <= '9'; ++j)
+            param = param * 10 + (sql[j] - '0');
+        max_param = std::max(max_param, param);
+    }
+    return max_param;
+}
+
+constexpr bool IsCatalogConsistent() {
+    for (size_t i = 0; i < STATEMENTS.size(); ++i) {
+        const auto& info = STATEMENTS[i];
+        if (static_cast<size_t>(info.id) != i || CountParams(info.sql) != info.arity)
+            return false;
+        for (size_t j = 0; j < i; ++j)
+            if (std::string_view{STATEMENTS[j].name} == info.name)
+                return false;
+    }
+    return true;
+}
+
+}  // namespace detail
+
+static_assert(detail::IsCatalogConsistent(),
+              "Statement catalog is out of order, has duplicate names or wrong arity");
+
+// Registers the whole catalog on the connection
+void PrepareStatements(pqxx::connection& connection);
+
+// Runs a catalog statement in the transaction, checking the argument count at compile time
+template <Statement id, typename Transaction, typename... Args>
+auto ExecPrepared(Transaction& work, Args&&... args) {
+    static_assert(sizeof...(Args) == GetStatementInfo(id).arity,
+                  "Argument count does not match the prepared statement");
+    return work.exec_prepared(GetStatementInfo(id).name, std::forward<Args>(args)...);
+}
+
+}  // namespace postgres
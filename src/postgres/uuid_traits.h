@@ -0,0 +1,70 @@
+#pragma once
+#include <pqxx/strconv>
+
+#include <cstddef>
+#include <string_view>
+
+#include "../util/tagged_uuid.h"
+
+// Lets tagged ids be read from result fields and streamed through COPY without a temporary std::string
+namespace pqxx {
+
+template <typename Tag>
+struct nullness<util::TaggedUUID<Tag>> : no_null<util::TaggedUUID<Tag>> {};
+
+template <typename Tag>
+struct string_traits<util::TaggedUUID<Tag>> {
+    using UUID = util::TaggedUUID<Tag>;
+
+    static constexpr bool converts_to_string{true};
+    static constexpr bool converts_from_string{true};
+
+    static UUID from_string(std::string_view text) {
+        return UUID{util::detail::UUIDFromString(text)};
+    }
+
+    static char* into_buf(char* begin, char* end, const UUID& value) {
+        if (end - begin < static_cast<std::ptrdiff_t>(size_buffer(value)))
+            throw conversion_overrun{"Not enough buffer space for a UUID"};
+        auto text_end = util::detail::UUIDToChars(*value, begin);
+        *text_end++ = '\0';
+        return text_end;
+    }
+
+    static zview to_buf(char* begin, char* end, const UUID& value) {
+        auto text_end = into_buf(begin, end, value);
+        return {begin, static_cast<size_t>(text_end - begin - 1)};
+    }
+
+    static constexpr size_t size_buffer(const UUID&) noexcept {
+        return util::detail::UUID_TEXT_SIZE + 1;
+    }
+};
+
+}  // namespace pqxx
+
+namespace postgres {
+
+// Sends an id as a 16-byte binary uuid parameter instead of its 36-character text form.
+// The view points into the id, which must outlive the statement call.
+template <typename Tag>
+std::basic_string_view<std::byte> BinaryUUID(const util::TaggedUUID<Tag>& id) noexcept {
+    const auto& uuid = *id;
+    return {reinterpret_cast<const std::byte*>(uuid.data), uuid.size()};
+}
+
+namespace detail {
+
+template <typename Arg>
+const Arg& AsParam(const Arg& arg) noexcept {
+    return arg;
+}
+
+template <typename Tag>
+std::basic_string_view<std::byte> AsParam(const util::TaggedUUID<Tag>& id) noexcept {
+    return BinaryUUID(id);
+}
+
+}  // namespace detail
+
+}  // namespace postgres
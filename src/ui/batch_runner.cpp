@@ -0,0 +1,157 @@
+#include "batch_runner.h"
+
+#include <boost/algorithm/string/trim.hpp>
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <utility>
+
+#include "../app/use_cases.h"
+#include "../menu/menu.h"
+
+using namespace std::literals;
+
+namespace ui {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto BEGIN_DIRECTIVE = "Begin"sv;
+constexpr auto COMMIT_DIRECTIVE = "Commit"sv;
+constexpr auto ROLLBACK_DIRECTIVE = "Rollback"sv;
+
+// Milliseconds with three decimals, padded to line up in the log
+std::string FormatMilliseconds(Clock::duration duration) {
+    constexpr size_t WIDTH = 10;
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                   std::chrono::duration<double, std::milli>(duration).count(),
+                                   std::chars_format::fixed, 3);
+    std::string text{buffer, end};
+    if (text.size() < WIDTH)
+        text.insert(0, WIDTH - text.size(), ' ');
+    return text;
+}
+
+}  // namespace
+
+BatchRunner::BatchRunner(menu::Menu& menu, app::UseCases& use_cases, std::istream& script, std::ostream& log,
+                         ErrorPolicy policy)
+    : menu_{menu}
+    , use_cases_{use_cases}
+    , script_{script}
+    , log_{log}
+    , policy_{policy} {
+}
+
+BatchReport BatchRunner::Run() {
+    BatchReport report;
+    const auto start = Clock::now();
+    std::string line;
+    while (std::getline(script_, line)) {
+        auto result = RunLine(boost::algorithm::trim_copy(line), report);
+        if (result == LineResult::Exit || (result == LineResult::Failed && policy_ == ErrorPolicy::Stop))
+            break;
+    }
+    if (in_batch_) {
+        if (!skipping_) {
+            use_cases_.RollbackBatch();
+            ++report.rolled_back_batches;
+        }
+        log_ << "Rolled back the transaction left open at the end of the script"sv << std::endl;
+    }
+    report.elapsed = Clock::now() - start;
+    log_ << report.commands << " commands, "sv << report.failed << " failed, "sv << report.skipped << " skipped, "sv
+         << report.committed_batches << " blocks committed, "sv << report.rolled_back_batches
+         << " rolled back in "sv << boost::algorithm::trim_copy(FormatMilliseconds(report.elapsed)) << " ms"sv
+         << std::endl;
+    return report;
+}
+
+BatchRunner::LineResult BatchRunner::RunLine(std::string_view line, BatchReport& report) {
+    if (line.empty() || line.front() == '#')
+        return LineResult::Done;
+    if (line == BEGIN_DIRECTIVE)
+        return Begin(report);
+    if (line == COMMIT_DIRECTIVE || line == ROLLBACK_DIRECTIVE)
+        return End(line == COMMIT_DIRECTIVE, report);
+    if (skipping_) {
+        ++report.skipped;
+        return LineResult::Done;
+    }
+    return RunCommand(line, report);
+}
+
+BatchRunner::LineResult BatchRunner::RunCommand(std::string_view line, BatchReport& report) {
+    ++report.commands;
+    // Commands report failures by cancelling their transaction or by throwing
+    const auto cancelled = use_cases_.GetCancelledTransactions();
+    const auto start = Clock::now();
+    auto result = menu_.Execute(line);
+    bool ok = result != menu::Menu::Result::Failed && use_cases_.GetCancelledTransactions() == cancelled;
+    LogTiming(Clock::now() - start, ok, line);
+    if (result == menu::Menu::Result::Exit)
+        return LineResult::Exit;
+    if (ok)
+        return LineResult::Done;
+
+    ++report.failed;
+    if (in_batch_) {
+        use_cases_.RollbackBatch();
+        ++report.rolled_back_batches;
+        skipping_ = true;
+    }
+    return LineResult::Failed;
+}
+
+BatchRunner::LineResult BatchRunner::Begin(BatchReport& report) {
+    if (in_batch_)
+        return Fail("Begin inside a Begin/Commit block"sv, report);
+    use_cases_.BeginBatch();
+    in_batch_ = true;
+    skipping_ = false;
+    return LineResult::Done;
+}
+
+BatchRunner::LineResult BatchRunner::End(bool commit, BatchReport& report) {
+    if (!in_batch_)
+        return Fail((commit ? COMMIT_DIRECTIVE : ROLLBACK_DIRECTIVE), report);
+    in_batch_ = false;
+    // A failed block was rolled back already
+    if (std::exchange(skipping_, false))
+        return LineResult::Done;
+    if (!commit) {
+        use_cases_.RollbackBatch();
+        ++report.rolled_back_batches;
+        return LineResult::Done;
+    }
+    const auto start = Clock::now();
+    bool ok = false;
+    try {
+        ok = use_cases_.CommitBatch();
+    } catch (const std::exception& e) {
+        log_ << "Failed to commit: "sv << e.what() << std::endl;
+    }
+    LogTiming(Clock::now() - start, ok, COMMIT_DIRECTIVE);
+    if (!ok) {
+        ++report.failed;
+        ++report.rolled_back_batches;
+        return LineResult::Failed;
+    }
+    ++report.committed_batches;
+    return LineResult::Done;
+}
+
+BatchRunner::LineResult BatchRunner::Fail(std::string_view message, BatchReport& report) {
+    ++report.failed;
+    log_ << "Unexpected "sv << message << std::endl;
+    return LineResult::Failed;
+}
+
+void BatchRunner::LogTiming(Clock::duration elapsed, bool ok, std::string_view line) {
+    log_ << FormatMilliseconds(elapsed) << " ms "sv
+         << (ok ? "ok     "sv : "FAILED "sv) << line << '\n';
+}
+
+}  // namespace ui
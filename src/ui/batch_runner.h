@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace menu {
+class Menu;
+}
+
+namespace app {
+class UseCases;
+}
+
+namespace ui {
+
+enum class ErrorPolicy {
+    // Stop at the first failed command
+    Stop,
+    // Go on with the next command; the rest of a failed Begin/Commit block is skipped
+    Continue,
+};
+
+struct BatchReport {
+    size_t commands = 0;
+    size_t failed = 0;
+    size_t skipped = 0;
+    size_t committed_batches = 0;
+    size_t rolled_back_batches = 0;
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+// Runs menu commands from a script, logging the time each one took. Commands between "Begin" and
+// "Commit" run in one transaction, which "Rollback" or a failed command discards; commands outside
+// such blocks commit one by one. Blank lines and lines starting with '#' are ignored. A command
+// that prompts reads its answers from the lines that follow it, as it would from the console.
+class BatchRunner {
+public:
+    BatchRunner(menu::Menu& menu, app::UseCases& use_cases, std::istream& script, std::ostream& log,
+                ErrorPolicy policy);
+
+    BatchReport Run();
+
+private:
+    enum class LineResult { Done, Failed, Exit };
+
+    LineResult RunLine(std::string_view line, BatchReport& report);
+    LineResult RunCommand(std::string_view line, BatchReport& report);
+    LineResult Begin(BatchReport& report);
+    LineResult End(bool commit, BatchReport& report);
+    LineResult Fail(std::string_view message, BatchReport& report);
+    void LogTiming(std::chrono::steady_clock::duration elapsed, bool ok, std::string_view line);
+
+    menu::Menu& menu_;
+    app::UseCases& use_cases_;
+    std::istream& script_;
+    std::ostream& log_;
+    ErrorPolicy policy_;
+    bool in_batch_ = false;
+    // Set when a command of the open block failed; its remaining commands are not run
+    bool skipping_ = false;
+};
+
+}  // namespace ui
@@ -0,0 +1,42 @@
+#include "output_buffer.h"
+
+#include <ostream>
+
+namespace ui {
+
+OutputBuffer::OutputBuffer(std::ostream& output, size_t capacity)
+    : output_{output}
+    , capacity_{capacity} {
+    buffer_.reserve(capacity_);
+}
+
+OutputBuffer::~OutputBuffer() {
+    try {
+        Flush();
+    } catch (...) {
+        // Streams configured to throw must not escape a destructor
+    }
+}
+
+void OutputBuffer::Flush() {
+    Drain();
+    output_.flush();
+}
+
+void OutputBuffer::Drain() {
+    if (buffer_.empty())
+        return;
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void OutputBuffer::Overflow(std::string_view text) {
+    Drain();
+    // Text too long to buffer goes straight to the stream
+    if (text.size() > capacity_)
+        output_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    else
+        buffer_.append(text);
+}
+
+}  // namespace ui
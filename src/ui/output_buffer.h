@@ -0,0 +1,56 @@
+#pragma once
+#include <charconv>
+#include <concepts>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace ui {
+
+// Collects formatted output in memory and hands it to the stream in large writes. Nothing reaches
+// the stream before Flush or before the buffer fills up, so callers flush before waiting for input.
+class OutputBuffer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    explicit OutputBuffer(std::ostream& output, size_t capacity = DEFAULT_CAPACITY);
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    ~OutputBuffer();
+
+    OutputBuffer& operator<<(std::string_view text) {
+        if (buffer_.size() + text.size() > capacity_)
+            Overflow(text);
+        else
+            buffer_.append(text);
+        return *this;
+    }
+
+    OutputBuffer& operator<<(char c) {
+        if (buffer_.size() == capacity_)
+            Drain();
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    template <std::integral Int>
+    OutputBuffer& operator<<(Int value) {
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        return *this << std::string_view{digits, static_cast<size_t>(end - digits)};
+    }
+
+    // Writes the buffered text and flushes the stream
+    void Flush();
+
+private:
+    // Writes the buffered text without flushing the stream
+    void Drain();
+    void Overflow(std::string_view text);
+
+    std::ostream& output_;
+    size_t capacity_;
+    std::string buffer_;
+};
+
+}  // namespace ui
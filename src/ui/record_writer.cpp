@@ -0,0 +1,166 @@
+#include "record_writer.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std::literals;
+
+namespace ui {
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Escape sequence of a character in a JSON string, or an empty view when it goes as is
+std::string_view JsonEscape(char c, char (&unicode)[6]) {
+    switch (c) {
+        case '"':
+            return "\\\""sv;
+        case '\\':
+            return "\\\\"sv;
+        case '\b':
+            return "\\b"sv;
+        case '\f':
+            return "\\f"sv;
+        case '\n':
+            return "\\n"sv;
+        case '\r':
+            return "\\r"sv;
+        case '\t':
+            return "\\t"sv;
+        default:
+            break;
+    }
+    const auto byte = static_cast<unsigned char>(c);
+    if (byte >= 0x20)
+        return {};
+    unicode[4] = HEX_DIGITS[byte >> 4];
+    unicode[5] = HEX_DIGITS[byte & 0xF];
+    return {unicode, sizeof(unicode)};
+}
+
+std::string_view TsvEscape(char c) {
+    switch (c) {
+        case '\\':
+            return "\\\\"sv;
+        case '\t':
+            return "\\t"sv;
+        case '\n':
+            return "\\n"sv;
+        case '\r':
+            return "\\r"sv;
+        default:
+            return {};
+    }
+}
+
+}  // namespace
+
+OutputFormat ParseOutputFormat(std::string_view name) {
+    if (name == "text"sv)
+        return OutputFormat::Text;
+    if (name == "jsonl"sv)
+        return OutputFormat::JsonLines;
+    if (name == "csv"sv)
+        return OutputFormat::Csv;
+    if (name == "tsv"sv)
+        return OutputFormat::Tsv;
+    throw std::invalid_argument("Unknown output format "s + std::string{name});
+}
+
+RecordWriter::RecordWriter(OutputBuffer& output, OutputFormat format, std::span<const std::string_view> columns)
+    : output_{output}
+    , format_{format}
+    , columns_{columns} {
+    if (format_ == OutputFormat::Text)
+        throw std::invalid_argument("Text listings have no record format");
+    if (format_ == OutputFormat::JsonLines)
+        return;
+    for (auto column : columns_)
+        Field(column);
+    EndRecord();
+}
+
+RecordWriter& RecordWriter::Field(std::string_view value) {
+    BeginField();
+    switch (format_) {
+        case OutputFormat::JsonLines:
+            WriteJsonString(value);
+            break;
+        case OutputFormat::Csv:
+            WriteCsvField(value);
+            break;
+        default:
+            WriteTsvField(value);
+            break;
+    }
+    return *this;
+}
+
+void RecordWriter::EndRecord() {
+    if (format_ == OutputFormat::JsonLines)
+        output_ << (field_ == 0 ? "{}"sv : "}"sv);
+    output_ << '\n';
+    field_ = 0;
+}
+
+void RecordWriter::BeginField() {
+    if (field_ >= columns_.size())
+        throw std::logic_error("More fields than columns in a record");
+    switch (format_) {
+        case OutputFormat::JsonLines:
+            output_ << (field_ == 0 ? '{' : ',');
+            WriteJsonString(columns_[field_]);
+            output_ << ':';
+            break;
+        case OutputFormat::Csv:
+            if (field_ > 0)
+                output_ << ',';
+            break;
+        default:
+            if (field_ > 0)
+                output_ << '\t';
+            break;
+    }
+    ++field_;
+}
+
+void RecordWriter::WriteJsonString(std::string_view text) {
+    char unicode[6] = {'\\', 'u', '0', '0', '0', '0'};
+    output_ << '"';
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (auto escape = JsonEscape(text[i], unicode); !escape.empty()) {
+            output_ << text.substr(run, i - run) << escape;
+            run = i + 1;
+        }
+    }
+    output_ << text.substr(run) << '"';
+}
+
+void RecordWriter::WriteCsvField(std::string_view text) {
+    if (text.find_first_of(",\"\r\n"sv) == std::string_view::npos) {
+        output_ << text;
+        return;
+    }
+    output_ << '"';
+    // Quotes inside a quoted field are doubled
+    for (auto quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"')) {
+        output_ << text.substr(0, quote + 1) << '"';
+        text.remove_prefix(quote + 1);
+    }
+    output_ << text << '"';
+}
+
+void RecordWriter::WriteTsvField(std::string_view text) {
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (auto escape = TsvEscape(text[i]); !escape.empty()) {
+            output_ << text.substr(run, i - run) << escape;
+            run = i + 1;
+        }
+    }
+    output_ << text.substr(run);
+}
+
+}  // namespace ui
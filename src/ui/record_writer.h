@@ -0,0 +1,54 @@
+#pragma once
+#include <concepts>
+#include <span>
+#include <string_view>
+
+#include "output_buffer.h"
+
+namespace ui {
+
+enum class OutputFormat {
+    // Human-readable listings
+    Text,
+    // One JSON object per line
+    JsonLines,
+    // RFC 4180 fields, quoted when needed, with a header row
+    Csv,
+    // Tab-separated fields with \t, \n, \r and \\ escaped, with a header row
+    Tsv,
+};
+
+// Accepts text, jsonl, csv and tsv
+OutputFormat ParseOutputFormat(std::string_view name);
+
+// Streams listing rows in a machine-readable format, escaping fields straight into the buffer.
+// Fields are written in the order of the columns, one EndRecord per row.
+class RecordWriter {
+public:
+    // Writes the header row of CSV and TSV; the columns must outlive the writer
+    RecordWriter(OutputBuffer& output, OutputFormat format, std::span<const std::string_view> columns);
+
+    RecordWriter& Field(std::string_view value);
+
+    template <std::integral Int>
+    RecordWriter& Field(Int value) {
+        BeginField();
+        output_ << value;
+        return *this;
+    }
+
+    void EndRecord();
+
+private:
+    void BeginField();
+    void WriteJsonString(std::string_view text);
+    void WriteCsvField(std::string_view text);
+    void WriteTsvField(std::string_view text);
+
+    OutputBuffer& output_;
+    OutputFormat format_;
+    std::span<const std::string_view> columns_;
+    size_t field_ = 0;
+};
+
+}  // namespace ui
@@ -4,6 +4,8 @@
 #include <cassert>
 #include <iostream>
 #include <set>
+
+#include "../app/listing_order.h"
 #include "../menu/menu.h"
 
 using namespace std::literals;
@@ -22,55 +24,108 @@ std::ostream& operator<<(std::ostream& out, const items::BookInfo& book) {
     return out;
 }
 
+// Rows shown at once when picking an author or a book from the catalog
+constexpr size_t SELECTION_PAGE_SIZE = 50;
+// Best matches shown by Search
+constexpr size_t SEARCH_RESULT_LIMIT = 20;
+
+// Columns of the machine-readable listings; "num" is the row number of the text listing
+constexpr std::string_view AUTHOR_COLUMNS[] = {"num"sv, "name"sv};
+constexpr std::string_view BOOK_COLUMNS[] = {"num"sv, "title"sv, "author"sv, "publication_year"sv};
+
+// Index of the item the user picked by number among count items numbered from first_num;
+// nullopt when the choice is not a number or names no listed item
+std::optional<size_t> ParseItemIndex(const std::string& choice, size_t first_num, size_t count) {
+    long long num;
+    try {
+        num = std::stoll(choice);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    if (num < 0 || static_cast<unsigned long long>(num) < first_num)
+        return std::nullopt;
+    auto index = static_cast<size_t>(num) - first_num;
+    if (index >= count)
+        return std::nullopt;
+    return index;
+}
+
 }  // namespace detail
 
-View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output)
+View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output,
+           OutputFormat format)
     : menu_{menu}
     , use_cases_{use_cases}
     , input_{input}
-    , output_{output} {
-    menu_.AddAction("AddAuthor"s, "name"s, "Adds author"s, std::bind(&View::AddAuthor, this, ph::_1));
-    menu_.AddAction("AddBook"s, "<pub year> <title>"s, "Adds book"s, std::bind(&View::AddBook, this, ph::_1));
-    menu_.AddAction("ShowAuthors"s, {}, "Show authors"s, std::bind(&View::ShowAuthors, this));
-    menu_.AddAction("ShowBooks"s, {}, "Show books"s, std::bind(&View::ShowBooks, this));
-    menu_.AddAction("ShowAuthorBooks"s, {}, "Show author books"s, std::bind(&View::ShowAuthorBooks, this));
-    menu_.AddAction("DeleteAuthor"s, {}, "Delete author"s, std::bind(&View::DeleteAuthor, this, ph::_1));
-    menu_.AddAction("EditAuthor"s, {}, "Edit author"s, std::bind(&View::EditAuthor, this, ph::_1));
-    menu_.AddAction("ShowBook"s, {}, "Show book"s, std::bind(&View::ShowBook, this, ph::_1));
-    menu_.AddAction("DeleteBook"s, {}, "Delete book"s, std::bind(&View::DeleteBook, this, ph::_1));
-    menu_.AddAction("EditBook"s, {}, "Edit book"s, std::bind(&View::EditBook, this, ph::_1));
+    , output_{output}
+    , format_{format} {
+    menu_.AddAction("AddAuthor"s, "name"s, "Adds author"s, FlushAfter(std::bind(&View::AddAuthor, this, ph::_1)));
+    menu_.AddAction("AddBook"s, "<pub year> <title>"s, "Adds book"s, FlushAfter(std::bind(&View::AddBook, this, ph::_1)));
+    menu_.AddAction("ShowAuthors"s, {}, "Show authors"s, FlushAfter(std::bind(&View::ShowAuthors, this)));
+    menu_.AddAction("ShowBooks"s, {}, "Show books"s, FlushAfter(std::bind(&View::ShowBooks, this)));
+    menu_.AddAction("ShowAuthorBooks"s, {}, "Show author books"s, FlushAfter(std::bind(&View::ShowAuthorBooks, this)));
+    menu_.AddAction("DeleteAuthor"s, {}, "Delete author"s, FlushAfter(std::bind(&View::DeleteAuthor, this, ph::_1)));
+    menu_.AddAction("EditAuthor"s, {}, "Edit author"s, FlushAfter(std::bind(&View::EditAuthor, this, ph::_1)));
+    menu_.AddAction("ShowBook"s, {}, "Show book"s, FlushAfter(std::bind(&View::ShowBook, this, ph::_1)));
+    menu_.AddAction("DeleteBook"s, {}, "Delete book"s, FlushAfter(std::bind(&View::DeleteBook, this, ph::_1)));
+    menu_.AddAction("EditBook"s, {}, "Edit book"s, FlushAfter(std::bind(&View::EditBook, this, ph::_1)));
+    menu_.AddAction("Search"s, "<text>"s, "Search books by title or author"s, FlushAfter(std::bind(&View::Search, this, ph::_1)));
+}
+
+View::Handler View::FlushAfter(Handler handler) {
+    return [this, handler = std::move(handler)](menu::CommandArgs args) {
+        try {
+            auto result = handler(args);
+            output_.Flush();
+            return result;
+        } catch (...) {
+            output_.Flush();
+            throw;
+        }
+    };
+}
+
+bool View::ReadLine(std::string& line) const {
+    output_.Flush();
+    return static_cast<bool>(std::getline(input_, line));
 }
 
 void View::PrintAuthors(const std::vector<items::AuthorInfo> &authors) const {
-    int author_num = 1;
+    size_t author_num = 1;
     for (auto & author: authors)
-        output_ << author_num++ << " " << author.name << std::endl;
+        PrintAuthorsRow(author_num++, author);
+}
+
+void View::PrintAuthorsRow(size_t author_num, const items::AuthorInfo &author) const {
+    output_ << author_num << " " << author.name << '\n';
 }
 
 void View::PrintBooks(const std::vector<items::BookInfo> &books) const {
-    int book_num = 1;
+    size_t book_num = 1;
     for (auto & book: books)
-        output_ << book_num++ << " " << book.title << " by " << book.author_name << ", " << book.publication_year << std::endl;
+        PrintBooksRow(book_num++, book);
+}
+
+void View::PrintBooksRow(size_t book_num, const items::BookInfo &book) const {
+    output_ << book_num << " " << book.title << " by " << book.author_name << ", " << book.publication_year << '\n';
 }
 
 void View::PrintAuthorBooks(const std::vector<items::BookInfo> &books) const {
     int book_num = 1;
     for (auto & book: books)
-        output_ << book_num++ << " " << book.title << ", " << book.publication_year << std::endl;
+        output_ << book_num++ << " " << book.title << ", " << book.publication_year << '\n';
 }
 
 void View::PrintBook(const items::BookInfo &book, const std::string &book_tags) const {
     output_ << "Title: " << book.title << "\nAuthor: " << book.author_name <<
-        "\nPublication year: " << book.publication_year << std::endl;
+        "\nPublication year: " << book.publication_year << '\n';
     if (!book_tags.empty())
-        output_ << "Tags: " << book_tags << std::endl;
+        output_ << "Tags: " << book_tags << '\n';
 }
 
-bool View::AddAuthor(std::istream& cmd_input) const {
+bool View::AddAuthor(menu::CommandArgs args) const {
     try {
-        std::string name;
-        std::getline(cmd_input, name);
-        boost::algorithm::trim(name);
+        std::string name{args.Rest()};
         if (name.empty())
             throw std::invalid_argument("Invalid author name");
         auto add_res = use_cases_.AddAuthor(name);
@@ -78,15 +133,15 @@ bool View::AddAuthor(std::istream& cmd_input) const {
             throw std::runtime_error("Failed to add author");
         use_cases_.EndTransaction();
     } catch (const std::exception&) {
-        output_ << "Failed to add author"sv << std::endl;
+        output_ << "Failed to add author"sv << '\n';
         use_cases_.CancelTransaction();
     }
     return true;
 }
 
-bool View::AddBook(std::istream& cmd_input) const {
+bool View::AddBook(menu::CommandArgs args) const {
     try {
-        if (auto params = GetBookParams(cmd_input)) {
+        if (auto params = GetBookParams(args)) {
             auto book_id = use_cases_.AddBook(params->title, params->publication_year, params->author_id);
             if (book_id.has_value()) {
                 AddBookTags(book_id.value());
@@ -98,7 +153,7 @@ bool View::AddBook(std::istream& cmd_input) const {
     } catch (const std::exception& e) {
         std::string error = e.what(), cancel = "cancel";
         if (error != cancel)
-            output_ << "Failed to add book: "sv << e.what() << std::endl;
+            output_ << "Failed to add book: "sv << e.what() << '\n';
         use_cases_.CancelTransaction();
     }
     return true;
@@ -115,11 +170,11 @@ std::vector<std::string> remove_duplicates(std::vector<std::string>&& vec) {
 
 std::vector<std::string> View::GetTags(const std::string& curr_tags) const {
     if (curr_tags.empty())
-        output_ << "Enter tags (comma separated):" << std::endl;
+        output_ << "Enter tags (comma separated):" << '\n';
     else
-        output_ << "Enter tags (current tags: " << curr_tags << "):" << std::endl;
+        output_ << "Enter tags (current tags: " << curr_tags << "):" << '\n';
     std::string tags_string;
-    std::getline(input_, tags_string);
+    ReadLine(tags_string);
     std::vector<std::string> tags{};
     if (tags_string.empty())
         return tags;
@@ -129,7 +184,7 @@ std::vector<std::string> View::GetTags(const std::string& curr_tags) const {
     return remove_duplicates(std::move(tags));
 }
 
-bool View::AddBookTags(const std::string& book_id) const {
+bool View::AddBookTags(const domain::BookId& book_id) const {
     try {
         auto tags = GetTags();
         if (!tags.empty()) {
@@ -146,24 +201,45 @@ bool View::AddBookTags(const std::string& book_id) const {
 
 bool View::ShowAuthors() const {
     auto authors = GetAuthors();
-    PrintAuthors(authors);
+    if (format_ == OutputFormat::Text) {
+        PrintAuthors(authors);
+    } else {
+        RecordWriter writer{output_, format_, detail::AUTHOR_COLUMNS};
+        int author_num = 1;
+        for (const auto& author : authors)
+            writer.Field(author_num++).Field(author.name).EndRecord();
+    }
+    use_cases_.EndTransaction();
     return true;
 }
 
 bool View::ShowBooks() const {
-    auto books = GetBooks();
-    std::sort(books.begin(), books.end(), [](auto &l, auto &r){
-        if (l.title == r.title) {
-            char new_c_l = std::tolower(l.author_name[0]), new_c_r = std::tolower(r.author_name[0]);
-            std::string new_name_l, new_name_r;
-            new_name_l += new_c_l;
-            new_name_l += l.author_name.substr(1);
-            new_name_r += new_c_r;
-            new_name_r += r.author_name.substr(1);
-            return new_name_l < new_name_r;
-        }
-        return l.title < r.title;
-    });
+    int book_num = 1;
+    if (format_ == OutputFormat::Text) {
+        use_cases_.ForEachBook([this, &book_num](const items::BookInfo& book) {
+            PrintBooksRow(book_num++, book);
+        });
+    } else {
+        RecordWriter writer{output_, format_, detail::BOOK_COLUMNS};
+        use_cases_.ForEachBook([&writer, &book_num](const items::BookInfo& book) {
+            writer.Field(book_num++).Field(book.title).Field(book.author_name).Field(book.publication_year);
+            writer.EndRecord();
+        });
+    }
+    use_cases_.EndTransaction();
+    return true;
+}
+
+bool View::Search(menu::CommandArgs args) const {
+    std::string query{args.Rest()};
+    if (query.empty()) {
+        output_ << "Enter text to search for" << '\n';
+        return true;
+    }
+    auto books = use_cases_.SearchBooks(query, detail::SEARCH_RESULT_LIMIT);
+    use_cases_.EndTransaction();
+    if (books.empty())
+        output_ << "No books found" << '\n';
     PrintBooks(books);
     return true;
 }
@@ -174,16 +250,16 @@ bool View::ShowAuthorBooks() const {
             auto author_books = GetAuthorBooks(*author_id);
             PrintAuthorBooks(author_books);
         }
+        use_cases_.EndTransaction();
     } catch (const std::exception& e) {
+        use_cases_.CancelTransaction();
         throw std::runtime_error("Failed to Show Books");
     }
     return true;
 }
 
-bool View::DeleteAuthor(std::istream& cmd_input) const {
-    std::string name;
-    std::getline(cmd_input, name);
-    boost::algorithm::trim(name);
+bool View::DeleteAuthor(menu::CommandArgs args) const {
+    std::string name{args.Rest()};
     if (name.empty()) {
         try {
             auto author_id = SelectAuthor();
@@ -193,7 +269,7 @@ bool View::DeleteAuthor(std::istream& cmd_input) const {
             } else
                 throw std::runtime_error("Invalid author id");
         } catch (const std::exception& e) {
-            output_ << "Failed to delete author: " << e.what() << std::endl;
+            output_ << "Failed to delete author: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     } else {
@@ -206,7 +282,7 @@ bool View::DeleteAuthor(std::istream& cmd_input) const {
             else
                 throw std::runtime_error("Author does not exist");
         } catch (const std::exception& e) {
-            output_ << "Failed to delete author: " << e.what() << std::endl;
+            output_ << "Failed to delete author: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     }
@@ -215,8 +291,8 @@ bool View::DeleteAuthor(std::istream& cmd_input) const {
 
 std::string View::GetAuthorName() const {
     std::string new_name;
-    output_ << "Enter new name: " << std::endl;
-    std::getline(input_, new_name);
+    output_ << "Enter new name: " << '\n';
+    ReadLine(new_name);
     boost::algorithm::trim(new_name);
     if (new_name.empty())
         throw std::runtime_error("Author name is empty");
@@ -227,28 +303,26 @@ void View::GetNewBookInfo(items::BookInfo& curr_info) const {
     std::string title, year;
     try {
         output_ << "Enter new title or empty line to use current one ("
-                << curr_info.title << "):" << std::endl;
-        std::getline(input_, title);
+                << curr_info.title << "):" << '\n';
+        ReadLine(title);
         if (!title.empty()) {
             boost::algorithm::trim(title);
             curr_info.title = title;
         }
         output_ << "Enter publication year or empty line to use the current one ("
-                << curr_info.publication_year << "):" << std::endl;
-        std::getline(input_, year);
+                << curr_info.publication_year << "):" << '\n';
+        ReadLine(year);
         if (!year.empty()) {
             int publication_year = std::stoi(year);
             curr_info.publication_year = publication_year;
         }
     } catch (const std::exception& e) {
-        output_ << "Failed to edit book: " << e.what() << std::endl;
+        output_ << "Failed to edit book: " << e.what() << '\n';
     }
 }
 
-bool View::EditAuthor(std::istream& cmd_input) const {
-    std::string name;
-    std::getline(cmd_input, name);
-    boost::algorithm::trim(name);
+bool View::EditAuthor(menu::CommandArgs args) const {
+    std::string name{args.Rest()};
     if (name.empty()) {
         try {
             auto author_id = SelectAuthor();
@@ -258,7 +332,7 @@ bool View::EditAuthor(std::istream& cmd_input) const {
             } else
                 throw std::runtime_error("Invalid author id");
         } catch (const std::exception& e) {
-            output_ << "Failed to edit author: " << e.what() << std::endl;
+            output_ << "Failed to edit author: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     } else {
@@ -271,7 +345,7 @@ bool View::EditAuthor(std::istream& cmd_input) const {
             else
                 throw std::runtime_error("Author does not exist");
         } catch (const std::exception& e) {
-            output_ << "Failed to edit author: " << e.what() << std::endl;
+            output_ << "Failed to edit author: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     }
@@ -290,10 +364,8 @@ std::string TagsToString(const std::vector<std::string>& tags) {
     return tag_str;
 }
 
-bool View::ShowBook(std::istream &cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
+bool View::ShowBook(menu::CommandArgs args) const {
+    std::string title{args.Rest()};
     if (title.empty()) {
         try {
             auto book = SelectBook();
@@ -303,134 +375,96 @@ bool View::ShowBook(std::istream &cmd_input) const {
                 PrintBook(book.value(), book_tags_str);
             }
         } catch (const std::exception& e) {
-            output_ << "Failed to find book: " << e.what() << std::endl;
+            output_ << "Failed to find book: " << e.what() << '\n';
+            use_cases_.CancelTransaction();
+            return true;
         }
     } else {
         try {
-            auto books = use_cases_.FindBookByTitle(title);
-            if (books.empty())
-                return true;
-            if (books.size() == 1) {
-                auto book = books[0];
-                auto book_tags = use_cases_.GetBookTags(book.id);
-                auto book_tags_str = TagsToString(book_tags);
-                PrintBook(book, book_tags_str);
-            } else {
-                auto book = SelectBookFromList(books);
-                if (book.has_value()) {
-                    auto book_tags = use_cases_.GetBookTags(book.value().id);
-                    auto book_tags_str = TagsToString(book_tags);
-                    PrintBook(book.value(), book_tags_str);
-                }
+            auto books = use_cases_.FindBookDetailsByTitle(title);
+            if (!books.empty()) {
+                auto book = books.size() == 1 ? std::optional{std::move(books[0])} : SelectBookFromList(books);
+                if (book.has_value())
+                    PrintBook(book->book, TagsToString(book->tags));
             }
         } catch (const std::exception& e) {
-            output_ << "Failed to find book: " << e.what() << std::endl;
+            output_ << "Failed to find book: " << e.what() << '\n';
+            use_cases_.CancelTransaction();
+            return true;
         }
     }
+    use_cases_.EndTransaction();
     return true;
 }
 
-bool View::DeleteBook(std::istream &cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
+bool View::DeleteBook(menu::CommandArgs args) const {
+    std::string title{args.Rest()};
     if (title.empty()) {
         try {
             auto book = SelectBook();
-            if (book.has_value()) {
+            if (book.has_value())
                 use_cases_.DeleteBook(book.value().id);
-                use_cases_.EndTransaction();
-            }
+            // Ends the read-only unit of the selection when nothing was deleted
+            use_cases_.EndTransaction();
         } catch (const std::exception& e) {
-            output_ << "Failed to delete book: " << e.what() << std::endl;
+            output_ << "Failed to delete book: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     } else {
         try {
-            auto books = use_cases_.FindBookByTitle(title);
-            if (books.empty())
-                return true;
-            if (books.size() == 1) {
-                auto book = books[0];
-                use_cases_.DeleteBook(book.id);
-                use_cases_.EndTransaction();
-            } else {
-                auto book = SelectBookFromList(books);
-                if (book.has_value()) {
-                    use_cases_.DeleteBook(book.value().id);
-                    use_cases_.EndTransaction();
-                }
+            auto books = use_cases_.FindBookDetailsByTitle(title);
+            if (!books.empty()) {
+                auto book = books.size() == 1 ? std::optional{std::move(books[0])} : SelectBookFromList(books);
+                if (book.has_value())
+                    use_cases_.DeleteBook(book->book.id);
             }
+            use_cases_.EndTransaction();
         } catch (const std::exception& e) {
-            output_ << "Failed to delete book: " << e.what() << std::endl;
+            output_ << "Failed to delete book: " << e.what() << '\n';
             use_cases_.CancelTransaction();
         }
     }
     return true;
 }
 
-bool View::EditBook(std::istream &cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
-    if (title.empty()) {
-        try {
-            auto book = SelectBook();
-            if (book.has_value()) {
-                GetNewBookInfo(book.value());
-                use_cases_.EditBook(book.value());
-                auto book_tags = use_cases_.GetBookTags(book->id);
-                auto book_tags_str = TagsToString(book_tags);
-                auto new_tags = GetTags(book_tags_str);
-                use_cases_.EditBookTags(book.value().id, new_tags);
-                use_cases_.EndTransaction();
-            } else
-                throw std::runtime_error("Book not found");
-        } catch (const std::exception& e) {
-            output_ << e.what() << std::endl;
-            use_cases_.CancelTransaction();
-        }
-    } else {
-        try {
-            auto books = use_cases_.FindBookByTitle(title);
+void View::EditBookDetails(items::BookDetails& book) const {
+    GetNewBookInfo(book.book);
+    use_cases_.EditBook(book.book);
+    auto new_tags = GetTags(TagsToString(book.tags));
+    use_cases_.EditBookTags(book.book.id, new_tags);
+    use_cases_.EndTransaction();
+}
+
+bool View::EditBook(menu::CommandArgs args) const {
+    std::string title{args.Rest()};
+    try {
+        std::optional<items::BookDetails> book;
+        if (title.empty()) {
+            if (auto selected = SelectBook()) {
+                auto book_tags = use_cases_.GetBookTags(selected->id);
+                book.emplace(items::BookDetails{std::move(*selected), std::move(book_tags)});
+            }
+        } else {
+            auto books = use_cases_.FindBookDetailsByTitle(title);
             if (books.empty())
                 throw std::runtime_error("Book not found");
-            if (books.size() == 1) {
-                auto book = books[0];
-                GetNewBookInfo(book);
-                use_cases_.EditBook(book);
-                auto book_tags = use_cases_.GetBookTags(book.id);
-                auto book_tags_str = TagsToString(book_tags);
-                auto new_tags = GetTags(book_tags_str);
-                use_cases_.EditBookTags(book.id, new_tags);
-                use_cases_.EndTransaction();
-            } else {
-                auto book = SelectBookFromList(books);
-                if (book.has_value()) {
-                    GetNewBookInfo(book.value());
-                    use_cases_.EditBook(book.value());
-                    auto book_tags = use_cases_.GetBookTags(book->id);
-                    auto book_tags_str = TagsToString(book_tags);
-                    auto new_tags = GetTags(book_tags_str);
-                    use_cases_.EditBookTags(book.value().id, new_tags);
-                    use_cases_.EndTransaction();
-                } else
-                    throw std::runtime_error("Book not found");
-            }
-        } catch (const std::exception& e) {
-            output_ << e.what() << std::endl;
-            use_cases_.CancelTransaction();
+            book = books.size() == 1 ? std::optional{std::move(books[0])} : SelectBookFromList(books);
         }
+        if (!book.has_value())
+            throw std::runtime_error("Book not found");
+        EditBookDetails(*book);
+    } catch (const std::exception& e) {
+        output_ << e.what() << '\n';
+        use_cases_.CancelTransaction();
     }
     return true;
 }
 
-std::optional<detail::AddBookParams> View::GetBookParams(std::istream& cmd_input) const {
+std::optional<detail::AddBookParams> View::GetBookParams(menu::CommandArgs args) const {
     detail::AddBookParams params;
 
-    cmd_input >> params.publication_year;
-    std::getline(cmd_input, params.title);
-    boost::algorithm::trim(params.title);
+    if (args.Next(params.publication_year))
+        params.title = args.Rest();
 
     auto author_id = AddBookAuthor();
     if (not author_id.has_value())
@@ -441,10 +475,10 @@ std::optional<detail::AddBookParams> View::GetBookParams(std::istream& cmd_input
     }
 }
 
-std::optional<std::string> View::AddBookAuthor() const {
-    output_ << "Enter author name or empty line to select from list:" << std::endl;
+std::optional<domain::AuthorId> View::AddBookAuthor() const {
+    output_ << "Enter author name or empty line to select from list:" << '\n';
     std::string author_name;
-    std::getline(input_, author_name);
+    ReadLine(author_name);
     if (author_name.empty()) {
         auto author_id = SelectAuthor();
         if (author_id.has_value())
@@ -457,14 +491,14 @@ std::optional<std::string> View::AddBookAuthor() const {
         if (author.has_value())
             return author.value().id;
         else {
-            output_ << "No author found. Do you want to add " << author_name << " (y/n)?" << std::endl;
+            output_ << "No author found. Do you want to add " << author_name << " (y/n)?" << '\n';
             std::string answer;
-            std::getline(input_, answer);
+            ReadLine(answer);
             if (answer == "y" || answer == "Y") {
                 try {
                     return use_cases_.AddAuthor(author_name);
                 } catch (const std::exception& e) {
-                    output_ << "Failed to add author" << std::endl;
+                    output_ << "Failed to add author" << '\n';
                 }
             }
             return std::nullopt;
@@ -472,103 +506,82 @@ std::optional<std::string> View::AddBookAuthor() const {
     }
 }
 
-std::optional<std::string> View::SelectAuthor() const {
-    output_ << "Select author:" << std::endl;
-    auto authors = GetAuthors();
-    PrintAuthors(authors);
-    output_ << "Enter author # or empty line to cancel" << std::endl;
-
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
-        return std::nullopt;
-    }
+template <typename Item>
+std::optional<Item> View::SelectFromPages(const PageFetcher<Item>& fetch_page, const RowPrinter<Item>& print_row,
+                                          const std::string& item_name) const {
+    std::optional<Item> after;
+    size_t first_num = 1;
+    while (true) {
+        auto page = fetch_page(after);
+        size_t item_num = first_num;
+        for (auto & item: page.items)
+            print_row(item_num++, item);
+        if (page.has_more)
+            output_ << "Enter " << item_name << " #, n for next page or empty line to cancel" << '\n';
+        else
+            output_ << "Enter " << item_name << " # or empty line to cancel" << '\n';
 
-    int author_idx;
-    try {
-        author_idx = std::stoi(str);
-    } catch (std::exception const&) {
-        throw std::runtime_error("Invalid author num");
-    }
+        std::string str;
+        if (!ReadLine(str) || str.empty()) {
+            return std::nullopt;
+        }
+        if (page.has_more && (str == "n" || str == "N")) {
+            first_num += page.items.size();
+            after = std::move(page.items.back());
+            continue;
+        }
 
-    --author_idx;
-    if (author_idx < 0 or author_idx >= authors.size()) {
-        throw std::runtime_error("Invalid author num");
+        auto item_idx = detail::ParseItemIndex(str, first_num, page.items.size());
+        if (!item_idx.has_value())
+            throw std::runtime_error("Invalid " + item_name + " num");
+        return std::move(page.items[*item_idx]);
     }
-
-    return authors[author_idx].id;
 }
 
-std::optional<items::BookInfo> View::SelectBook() const {
-    auto books = GetBooks();
-    std::sort(books.begin(), books.end(), [](auto &l, auto &r){
-        if (l.title == r.title) {
-            char new_c_l = std::tolower(l.author_name[0]), new_c_r = std::tolower(r.author_name[0]);
-            std::string new_name_l, new_name_r;
-            new_name_l += new_c_l;
-            new_name_l += l.author_name.substr(1);
-            new_name_r += new_c_r;
-            new_name_r += r.author_name.substr(1);
-            return new_name_l < new_name_r;
-        }
-        return l.title < r.title;
-    });
-    PrintBooks(books);
-    output_ << "Enter book # or empty line to cancel" << std::endl;
-
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
+std::optional<domain::AuthorId> View::SelectAuthor() const {
+    output_ << "Select author:" << '\n';
+    auto author = SelectFromPages<items::AuthorInfo>(
+            [this](const std::optional<items::AuthorInfo>& after) {
+                return use_cases_.GetAuthorsPage(after, detail::SELECTION_PAGE_SIZE);
+            },
+            [this](size_t author_num, const items::AuthorInfo& author) {
+                PrintAuthorsRow(author_num, author);
+            },
+            "author");
+    if (!author.has_value())
         return std::nullopt;
-    }
-
-    int book_idx;
-    try {
-        book_idx = std::stoi(str);
-    } catch (std::exception const&) {
-        throw std::runtime_error("Invalid book num");
-    }
-
-    --book_idx;
-    if (book_idx < 0 or book_idx >= books.size()) {
-        throw std::runtime_error("Invalid book num");
-    }
+    return std::move(author->id);
+}
 
-    return books[book_idx];
+std::optional<items::BookInfo> View::SelectBook() const {
+    return SelectFromPages<items::BookInfo>(
+            [this](const std::optional<items::BookInfo>& after) {
+                return use_cases_.GetBooksPage(after, detail::SELECTION_PAGE_SIZE);
+            },
+            [this](size_t book_num, const items::BookInfo& book) {
+                PrintBooksRow(book_num, book);
+            },
+            "book");
 }
 
-std::optional<items::BookInfo> View::SelectBookFromList(std::vector<items::BookInfo>& books) const {
-    std::sort(books.begin(), books.end(), [](auto &l, auto &r){
-        if (l.title == r.title) {
-            char new_c_l = std::tolower(l.author_name[0]), new_c_r = std::tolower(r.author_name[0]);
-            std::string new_name_l, new_name_r;
-            new_name_l += new_c_l;
-            new_name_l += l.author_name.substr(1);
-            new_name_r += new_c_r;
-            new_name_r += r.author_name.substr(1);
-            return new_name_l < new_name_r;
-        }
-        return l.title < r.title;
+std::optional<items::BookDetails> View::SelectBookFromList(std::vector<items::BookDetails>& books) const {
+    app::SortBooks(books, [](const items::BookDetails& details) -> const items::BookInfo& {
+        return details.book;
     });
-    PrintBooks(books);
-    output_ << "Enter book # or empty line to cancel" << std::endl;
+    size_t book_num = 1;
+    for (auto & book: books)
+        PrintBooksRow(book_num++, book.book);
+    output_ << "Enter book # or empty line to cancel" << '\n';
 
     std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
+    if (!ReadLine(str) || str.empty()) {
         return std::nullopt;
     }
 
-    int book_idx;
-    try {
-        book_idx = std::stoi(str);
-    } catch (std::exception const&) {
-        throw std::runtime_error("Invalid book num");
-    }
-
-    --book_idx;
-    if (book_idx < 0 or book_idx >= books.size()) {
+    auto book_idx = detail::ParseItemIndex(str, 1, books.size());
+    if (!book_idx.has_value())
         throw std::runtime_error("Invalid book num");
-    }
-
-    return books[book_idx];
+    return std::move(books[*book_idx]);
 }
 
 std::vector<items::AuthorInfo> View::GetAuthors() const {
@@ -579,7 +592,7 @@ std::vector<items::BookInfo> View::GetBooks() const {
     return use_cases_.GetBooks();
 }
 
-std::vector<items::BookInfo> View::GetAuthorBooks(const std::string& author_id) const {
+std::vector<items::BookInfo> View::GetAuthorBooks(const domain::AuthorId& author_id) const {
     return use_cases_.GetAuthorBooks(author_id);
 }
 
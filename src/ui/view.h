@@ -1,10 +1,14 @@
 #pragma once
+#include <functional>
 #include <iosfwd>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "../app/use_cases.h"
+#include "../menu/command_args.h"
+#include "output_buffer.h"
+#include "record_writer.h"
 
 namespace menu {
 class Menu;
@@ -19,7 +23,7 @@ namespace detail {
 
 struct AddBookParams {
     std::string title;
-    std::string author_id;
+    domain::AuthorId author_id;
     int publication_year = 0;
 };
 
@@ -27,41 +31,63 @@ struct AddBookParams {
 
 class View {
 public:
-    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output);
+    // Book and author listings are written in the given format; everything else stays text
+    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output,
+         OutputFormat format = OutputFormat::Text);
 
 private:
-    bool AddAuthor(std::istream& cmd_input) const;
-    bool AddBook(std::istream& cmd_input) const;
-    bool AddBookTags(const std::string& book_id) const;
+    using Handler = std::function<bool(menu::CommandArgs)>;
+
+    // Flushes the command's output when it returns or throws
+    Handler FlushAfter(Handler handler);
+    // Flushes pending output before waiting for the user
+    bool ReadLine(std::string& line) const;
+
+    bool AddAuthor(menu::CommandArgs args) const;
+    bool AddBook(menu::CommandArgs args) const;
+    bool AddBookTags(const domain::BookId& book_id) const;
     bool ShowAuthors() const;
     bool ShowBooks() const;
     bool ShowAuthorBooks() const;
-    bool DeleteAuthor(std::istream& cmd_input) const;
-    bool EditAuthor(std::istream& cmd_input) const;
-    bool DeleteBook(std::istream& cmd_input) const;
-    bool EditBook(std::istream& cmd_input) const;
+    bool DeleteAuthor(menu::CommandArgs args) const;
+    bool EditAuthor(menu::CommandArgs args) const;
+    bool DeleteBook(menu::CommandArgs args) const;
+    bool EditBook(menu::CommandArgs args) const;
+    bool Search(menu::CommandArgs args) const;
     std::string GetAuthorName() const;
-    bool ShowBook(std::istream& cmd_input) const;
+    bool ShowBook(menu::CommandArgs args) const;
     void PrintBooks(const std::vector<items::BookInfo>& books) const;
+    void PrintBooksRow(size_t book_num, const items::BookInfo& book) const;
     void PrintAuthorBooks(const std::vector<items::BookInfo>& books) const;
     void PrintAuthors(const std::vector<items::AuthorInfo>& authors) const;
+    void PrintAuthorsRow(size_t author_num, const items::AuthorInfo& author) const;
     void PrintBook(const items::BookInfo& book, const std::string& book_tags) const;
-    std::optional<items::BookInfo> SelectBookFromList(std::vector<items::BookInfo>& books) const;
+    std::optional<items::BookDetails> SelectBookFromList(std::vector<items::BookDetails>& books) const;
+    void EditBookDetails(items::BookDetails& book) const;
 
-    std::optional<detail::AddBookParams> GetBookParams(std::istream& cmd_input) const;
-    std::optional<std::string> AddBookAuthor() const;
-    std::optional<std::string> SelectAuthor() const;
+    std::optional<detail::AddBookParams> GetBookParams(menu::CommandArgs args) const;
+    std::optional<domain::AuthorId> AddBookAuthor() const;
+    std::optional<domain::AuthorId> SelectAuthor() const;
     std::optional<items::BookInfo> SelectBook() const;
+
+    template <typename Item>
+    using PageFetcher = std::function<items::Page<Item>(const std::optional<Item>&)>;
+    template <typename Item>
+    using RowPrinter = std::function<void(size_t, const Item&)>;
+    template <typename Item>
+    std::optional<Item> SelectFromPages(const PageFetcher<Item>& fetch_page, const RowPrinter<Item>& print_row,
+                                        const std::string& item_name) const;
     std::vector<items::AuthorInfo> GetAuthors() const;
     std::vector<items::BookInfo> GetBooks() const;
-    std::vector<items::BookInfo> GetAuthorBooks(const std::string& author_id) const;
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId& author_id) const;
     std::vector<std::string> GetTags(const std::string& curr_tags = "") const;
     void GetNewBookInfo(items::BookInfo& curr_info) const;
 
     menu::Menu& menu_;
     app::UseCases& use_cases_;
     std::istream& input_;
-    std::ostream& output_;
+    mutable OutputBuffer output_;
+    OutputFormat format_;
 };
 
 }  // namespace ui
\ No newline at end of file
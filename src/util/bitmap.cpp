@@ -0,0 +1,270 @@
+#include "bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace util {
+
+namespace {
+
+// An array this long takes as much memory as the bitset
+constexpr uint32_t ARRAY_LIMIT = 4096;
+constexpr size_t BITSET_WORDS = 1024;
+
+uint16_t HighHalf(uint32_t value) noexcept {
+    return static_cast<uint16_t>(value >> 16);
+}
+
+uint16_t LowHalf(uint32_t value) noexcept {
+    return static_cast<uint16_t>(value & 0xffff);
+}
+
+bool TestBit(const std::vector<uint64_t>& words, uint16_t low) noexcept {
+    return (words[low >> 6] >> (low & 63)) & 1;
+}
+
+template <typename Container>
+void MakeDense(Container& container) {
+    container.words.assign(BITSET_WORDS, 0);
+    for (uint16_t low: container.values)
+        container.words[low >> 6] |= uint64_t{1} << (low & 63);
+    container.values.clear();
+    container.values.shrink_to_fit();
+}
+
+// Recounts a bitset after a bulk operation and turns it back into an array when it gets sparse
+template <typename Container>
+void Normalize(Container& container) {
+    if (!container.IsDense()) {
+        container.cardinality = static_cast<uint32_t>(container.values.size());
+        return;
+    }
+    uint32_t cardinality = 0;
+    for (uint64_t word: container.words)
+        cardinality += std::popcount(word);
+    container.cardinality = cardinality;
+    if (cardinality > ARRAY_LIMIT)
+        return;
+    container.values.clear();
+    container.values.reserve(cardinality);
+    for (size_t i = 0; i < BITSET_WORDS; ++i) {
+        for (uint64_t word = container.words[i]; word != 0; word &= word - 1)
+            container.values.push_back(static_cast<uint16_t>(i * 64 + std::countr_zero(word)));
+    }
+    container.words.clear();
+    container.words.shrink_to_fit();
+}
+
+template <typename Container>
+bool ContainerContains(const Container& container, uint16_t low) noexcept {
+    if (container.IsDense())
+        return TestBit(container.words, low);
+    return std::binary_search(container.values.begin(), container.values.end(), low);
+}
+
+template <typename Container>
+void AndInto(Container& container, const Container& other) {
+    if (container.IsDense() && other.IsDense()) {
+        for (size_t i = 0; i < BITSET_WORDS; ++i)
+            container.words[i] &= other.words[i];
+    } else if (container.IsDense()) {
+        std::vector<uint16_t> values;
+        for (uint16_t low: other.values) {
+            if (TestBit(container.words, low))
+                values.push_back(low);
+        }
+        container.words.clear();
+        container.words.shrink_to_fit();
+        container.values = std::move(values);
+    } else {
+        auto removed = std::remove_if(container.values.begin(), container.values.end(), [&other](uint16_t low) {
+            return !ContainerContains(other, low);
+        });
+        container.values.erase(removed, container.values.end());
+    }
+    Normalize(container);
+}
+
+template <typename Container>
+void OrInto(Container& container, const Container& other) {
+    if (!container.IsDense() && !other.IsDense()) {
+        std::vector<uint16_t> values;
+        values.reserve(container.values.size() + other.values.size());
+        std::set_union(container.values.begin(), container.values.end(), other.values.begin(), other.values.end(),
+                       std::back_inserter(values));
+        container.values = std::move(values);
+        container.cardinality = static_cast<uint32_t>(container.values.size());
+        if (container.cardinality > ARRAY_LIMIT)
+            MakeDense(container);
+        return;
+    }
+    if (!container.IsDense())
+        MakeDense(container);
+    if (other.IsDense()) {
+        for (size_t i = 0; i < BITSET_WORDS; ++i)
+            container.words[i] |= other.words[i];
+    } else {
+        for (uint16_t low: other.values)
+            container.words[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    Normalize(container);
+}
+
+template <typename Container>
+void AndNotInto(Container& container, const Container& other) {
+    if (!container.IsDense()) {
+        auto removed = std::remove_if(container.values.begin(), container.values.end(), [&other](uint16_t low) {
+            return ContainerContains(other, low);
+        });
+        container.values.erase(removed, container.values.end());
+    } else if (other.IsDense()) {
+        for (size_t i = 0; i < BITSET_WORDS; ++i)
+            container.words[i] &= ~other.words[i];
+    } else {
+        for (uint16_t low: other.values)
+            container.words[low >> 6] &= ~(uint64_t{1} << (low & 63));
+    }
+    Normalize(container);
+}
+
+}  // namespace
+
+std::vector<Bitmap::Container>::iterator Bitmap::Find(uint16_t key) {
+    return std::lower_bound(containers_.begin(), containers_.end(), key, [](const Container& container, uint16_t key) {
+        return container.key < key;
+    });
+}
+
+std::vector<Bitmap::Container>::const_iterator Bitmap::Find(uint16_t key) const {
+    return std::lower_bound(containers_.begin(), containers_.end(), key, [](const Container& container, uint16_t key) {
+        return container.key < key;
+    });
+}
+
+void Bitmap::Add(uint32_t value) {
+    const uint16_t key = HighHalf(value), low = LowHalf(value);
+    auto it = Find(key);
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.insert(it, Container{});
+        it->key = key;
+    }
+    if (it->IsDense()) {
+        auto& word = it->words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        if ((word & bit) == 0) {
+            word |= bit;
+            ++it->cardinality;
+        }
+        return;
+    }
+    auto pos = std::lower_bound(it->values.begin(), it->values.end(), low);
+    if (pos != it->values.end() && *pos == low)
+        return;
+    it->values.insert(pos, low);
+    if (++it->cardinality > ARRAY_LIMIT)
+        MakeDense(*it);
+}
+
+void Bitmap::Remove(uint32_t value) {
+    const uint16_t key = HighHalf(value), low = LowHalf(value);
+    auto it = Find(key);
+    if (it == containers_.end() || it->key != key)
+        return;
+    if (it->IsDense()) {
+        auto& word = it->words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        if ((word & bit) == 0)
+            return;
+        word &= ~bit;
+        if (--it->cardinality <= ARRAY_LIMIT)
+            Normalize(*it);
+    } else {
+        auto pos = std::lower_bound(it->values.begin(), it->values.end(), low);
+        if (pos == it->values.end() || *pos != low)
+            return;
+        it->values.erase(pos);
+        --it->cardinality;
+    }
+    if (it->cardinality == 0)
+        containers_.erase(it);
+}
+
+bool Bitmap::Contains(uint32_t value) const noexcept {
+    const uint16_t key = HighHalf(value);
+    auto it = Find(key);
+    return it != containers_.end() && it->key == key && ContainerContains(*it, LowHalf(value));
+}
+
+size_t Bitmap::Cardinality() const noexcept {
+    size_t cardinality = 0;
+    for (const auto& container: containers_)
+        cardinality += container.cardinality;
+    return cardinality;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    std::vector<Container> result;
+    auto it = other.containers_.begin();
+    for (auto& container: containers_) {
+        while (it != other.containers_.end() && it->key < container.key)
+            ++it;
+        if (it == other.containers_.end())
+            break;
+        if (it->key != container.key)
+            continue;
+        AndInto(container, *it);
+        if (container.cardinality != 0)
+            result.push_back(std::move(container));
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers_.size() + other.containers_.size());
+    auto left = containers_.begin();
+    auto right = other.containers_.begin();
+    while (left != containers_.end() || right != other.containers_.end()) {
+        if (right == other.containers_.end() || (left != containers_.end() && left->key < right->key)) {
+            result.push_back(std::move(*left++));
+        } else if (left == containers_.end() || right->key < left->key) {
+            result.push_back(*right++);
+        } else {
+            OrInto(*left, *right++);
+            result.push_back(std::move(*left++));
+        }
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+Bitmap& Bitmap::operator-=(const Bitmap& other) {
+    std::vector<Container> result;
+    auto it = other.containers_.begin();
+    for (auto& container: containers_) {
+        while (it != other.containers_.end() && it->key < container.key)
+            ++it;
+        if (it != other.containers_.end() && it->key == container.key)
+            AndNotInto(container, *it);
+        if (container.cardinality != 0)
+            result.push_back(std::move(container));
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+std::vector<uint32_t> Bitmap::ToVector() const {
+    std::vector<uint32_t> values;
+    values.reserve(Cardinality());
+    ForEach([&values](uint32_t value) {
+        values.push_back(value);
+    });
+    return values;
+}
+
+bool Bitmap::operator==(const Bitmap& other) const {
+    return Cardinality() == other.Cardinality() && ToVector() == other.ToVector();
+}
+
+}  // namespace util
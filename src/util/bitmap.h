@@ -0,0 +1,72 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+// Compressed set of 32-bit values in the style of Roaring bitmaps. Values are split by their
+// high 16 bits into containers; a container is a sorted array while it holds few values and
+// becomes a 64 Kbit bitset once it fills up, so both sparse and dense sets stay compact.
+class Bitmap {
+public:
+    void Add(uint32_t value);
+    void Remove(uint32_t value);
+    bool Contains(uint32_t value) const noexcept;
+
+    size_t Cardinality() const noexcept;
+    bool Empty() const noexcept {
+        return containers_.empty();
+    }
+
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator|=(const Bitmap& other);
+    // Removes every value present in other
+    Bitmap& operator-=(const Bitmap& other);
+
+    // Visits values in increasing order
+    template <typename Fn>
+    void ForEach(Fn&& fn) const;
+
+    std::vector<uint32_t> ToVector() const;
+
+    bool operator==(const Bitmap& other) const;
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        // Sorted low halves while the container is sparse
+        std::vector<uint16_t> values;
+        // 1024 words once it is dense; empty otherwise
+        std::vector<uint64_t> words;
+
+        bool IsDense() const noexcept {
+            return !words.empty();
+        }
+    };
+
+    std::vector<Container>::iterator Find(uint16_t key);
+    std::vector<Container>::const_iterator Find(uint16_t key) const;
+
+    std::vector<Container> containers_;
+};
+
+template <typename Fn>
+void Bitmap::ForEach(Fn&& fn) const {
+    for (const auto& container: containers_) {
+        const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+        if (!container.IsDense()) {
+            for (uint16_t low: container.values)
+                fn(high | low);
+            continue;
+        }
+        for (size_t i = 0; i < container.words.size(); ++i) {
+            for (uint64_t word = container.words[i]; word != 0; word &= word - 1)
+                fn(high | static_cast<uint32_t>(i * 64 + std::countr_zero(word)));
+        }
+    }
+}
+
+}  // namespace util
@@ -0,0 +1,114 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+// Bounded map evicting the least recently used entries. Keys are spread over independently
+// locked shards so concurrent lookups of different keys rarely contend; recency and the size
+// bound are kept per shard.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+public:
+    explicit ShardedLruCache(size_t capacity, size_t shard_count = 16)
+        : shard_capacity_{std::max<size_t>(1, (capacity + shard_count - 1) / shard_count)} {
+        shards_.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; ++i)
+            shards_.push_back(std::make_unique<Shard>());
+    }
+
+    std::optional<Value> Get(const Key& key) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock{shard.mutex};
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+            return std::nullopt;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->second;
+    }
+
+    void Put(const Key& key, Value value) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock{shard.mutex};
+        if (auto it = shard.index.find(key); it != shard.index.end()) {
+            it->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+        if (shard.entries.size() > shard_capacity_) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+    }
+
+    void Erase(const Key& key) {
+        auto& shard = GetShard(key);
+        std::lock_guard lock{shard.mutex};
+        if (auto it = shard.index.find(key); it != shard.index.end()) {
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+
+    // Visits every shard; for invalidations that cannot be addressed by key
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate) {
+        for (auto& shard: shards_) {
+            std::lock_guard lock{shard->mutex};
+            for (auto it = shard->entries.begin(); it != shard->entries.end();) {
+                if (predicate(it->first, it->second)) {
+                    shard->index.erase(it->first);
+                    it = shard->entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    void Clear() {
+        for (auto& shard: shards_) {
+            std::lock_guard lock{shard->mutex};
+            shard->index.clear();
+            shard->entries.clear();
+        }
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (const auto& shard: shards_) {
+            std::lock_guard lock{shard->mutex};
+            size += shard->entries.size();
+        }
+        return size;
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        // Most recently used first
+        Entries entries;
+        std::unordered_map<Key, typename Entries::iterator, Hash> index;
+    };
+
+    Shard& GetShard(const Key& key) {
+        return *shards_[Hash{}(key) % shards_.size()];
+    }
+
+    size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace util
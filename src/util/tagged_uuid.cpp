@@ -1,23 +1,258 @@
 #include "tagged_uuid.h"
 
 #include <boost/uuid/random_generator.hpp>
-#include <boost/uuid/string_generator.hpp>
-#include <boost/uuid/uuid_io.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace util {
+
+namespace {
+
+std::atomic<UUIDVersion> uuid_version{UUIDVersion::Random};
+
+// Seeding from the OS is expensive, so each thread seeds its own generator once
+boost::uuids::random_generator_mt19937& ThreadGenerator() {
+    thread_local boost::uuids::random_generator_mt19937 generator;
+    return generator;
+}
+
+}  // namespace
+
+void SetUUIDVersion(UUIDVersion version) noexcept {
+    uuid_version.store(version, std::memory_order_relaxed);
+}
+
+UUIDVersion GetUUIDVersion() noexcept {
+    return uuid_version.load(std::memory_order_relaxed);
+}
+
 namespace detail {
 
 UUIDType NewUUID() {
-    return boost::uuids::random_generator()();
+    return GetUUIDVersion() == UUIDVersion::TimeOrdered ? NewTimeOrderedUUID() : NewRandomUUID();
 }
 
+UUIDType NewRandomUUID() {
+    return ThreadGenerator()();
+}
+
+// RFC 9562 layout: 48-bit Unix time in ms, version, 12-bit counter, variant, 62 random bits.
+// The counter keeps ids from one thread increasing within a millisecond.
+UUIDType NewTimeOrderedUUID() {
+    thread_local uint64_t last_ms = 0;
+    thread_local uint16_t counter = 0;
+
+    auto uuid = ThreadGenerator()();
+    uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    if (now_ms > last_ms) {
+        last_ms = now_ms;
+        counter = 0;
+    } else if (++counter > 0x0fff) {
+        // Counter exhausted (or the clock went back): borrow the next millisecond
+        ++last_ms;
+        counter = 0;
+    }
+
+    for (int i = 0; i < 6; ++i)
+        uuid.data[i] = static_cast<uint8_t>(last_ms >> (40 - 8 * i));
+    uuid.data[6] = static_cast<uint8_t>(0x70 | (counter >> 8));
+    uuid.data[7] = static_cast<uint8_t>(counter);
+    uuid.data[8] = static_cast<uint8_t>(0x80 | (uuid.data[8] & 0x3f));
+    return uuid;
+}
+
+namespace {
+
+// Offsets of the dashes in the canonical 8-4-4-4-12 form
+constexpr size_t DASH_POSITIONS[]{8, 13, 18, 23};
+constexpr size_t UUID_HEX_SIZE = 32;
+
+// Gathers the 32 hex digits of a canonical UUID; false if the dashes are misplaced
+bool GatherHexDigits(std::string_view str, char* hex) noexcept {
+    if (str.size() != UUID_TEXT_SIZE)
+        return false;
+    for (size_t pos: DASH_POSITIONS) {
+        if (str[pos] != '-')
+            return false;
+    }
+    std::memcpy(hex, str.data(), 8);
+    std::memcpy(hex + 8, str.data() + 9, 4);
+    std::memcpy(hex + 12, str.data() + 14, 4);
+    std::memcpy(hex + 16, str.data() + 19, 4);
+    std::memcpy(hex + 20, str.data() + 24, 12);
+    return true;
+}
+
+void ScatterHexDigits(const char* hex, char* out) noexcept {
+    std::memcpy(out, hex, 8);
+    std::memcpy(out + 9, hex + 8, 4);
+    std::memcpy(out + 14, hex + 12, 4);
+    std::memcpy(out + 19, hex + 16, 4);
+    std::memcpy(out + 24, hex + 20, 12);
+    for (size_t pos: DASH_POSITIONS)
+        out[pos] = '-';
+}
+
+[[maybe_unused]] bool ParseHexScalar(const char* hex, uint8_t* bytes) noexcept {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        c = static_cast<char>(c | 0x20);
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        return -1;
+    };
+    int invalid = 0;
+    for (size_t i = 0; i < UUID_HEX_SIZE / 2; ++i) {
+        int hi = nibble(hex[2 * i]), lo = nibble(hex[2 * i + 1]);
+        invalid |= hi | lo;
+        bytes[i] = static_cast<uint8_t>(hi << 4 | lo);
+    }
+    return invalid >= 0;
+}
+
+[[maybe_unused]] void FormatHexScalar(const uint8_t* bytes, char* hex) noexcept {
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    for (size_t i = 0; i < UUID_HEX_SIZE / 2; ++i) {
+        hex[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+        hex[2 * i + 1] = HEX_DIGITS[bytes[i] & 0x0f];
+    }
+}
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+
+// Maps ASCII hex digits to their values and flags any other byte.
+// Bytes outside ASCII are negative as signed chars and fall outside both ranges.
+__m128i HexToNibbles(__m128i chars, __m128i& invalid) noexcept {
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)),
+                                           _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+    const __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(letter, _mm_set1_epi8(-1)),
+                                            _mm_cmplt_epi8(letter, _mm_set1_epi8(6)));
+    invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8(-1)));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// Folds the two nibbles of each 16-bit lane (high nibble first in memory) into one byte
+__m128i NibblePairsToBytes(__m128i nibbles) noexcept {
+    const __m128i hi = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00ff)), 4);
+    const __m128i lo = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(hi, lo);
+}
+
+__m128i NibblesToHex(__m128i nibbles) noexcept {
+    const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+bool ParseHex(const char* hex, uint8_t* bytes) noexcept {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex));
+    const __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_digit = _mm256_and_si256(_mm256_cmpgt_epi8(digit, _mm256_set1_epi8(-1)),
+                                              _mm256_cmpgt_epi8(_mm256_set1_epi8(10), digit));
+    const __m256i is_letter = _mm256_and_si256(_mm256_cmpgt_epi8(letter, _mm256_set1_epi8(-1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8(6), letter));
+    if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1)
+        return false;
+    const __m256i nibbles = _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                                            _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+    // Each 16-bit lane holds a digit pair; fold it into one byte, then gather the low halves of both lanes
+    const __m256i words = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00ff)), 4),
+                                          _mm256_srli_epi16(nibbles, 8));
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(words, words), 0b1000);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm256_castsi256_si128(packed));
+    return true;
+}
+
+void FormatHex(const uint8_t* bytes, char* hex) noexcept {
+    const __m256i words = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)));
+    // High nibble goes to the low byte of each lane so it lands first in memory
+    const __m256i nibbles = _mm256_or_si256(_mm256_srli_epi16(words, 4),
+                                            _mm256_slli_epi16(_mm256_and_si256(words, _mm256_set1_epi16(0x0f)), 8));
+    const __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)),
+                                             _mm256_set1_epi8('a' - '0' - 10));
+    const __m256i chars = _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hex), chars);
+}
+
+#elif defined(__SSE2__)
+
+bool ParseHex(const char* hex, uint8_t* bytes) noexcept {
+    __m128i invalid = _mm_setzero_si128();
+    const __m128i first = HexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex)), invalid);
+    const __m128i second = HexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16)), invalid);
+    if (_mm_movemask_epi8(invalid) != 0)
+        return false;
+    const __m128i packed = _mm_packus_epi16(NibblePairsToBytes(first), NibblePairsToBytes(second));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), packed);
+    return true;
+}
+
+void FormatHex(const uint8_t* bytes, char* hex) noexcept {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(value, 4), _mm_set1_epi8(0x0f));
+    const __m128i lo = _mm_and_si128(value, _mm_set1_epi8(0x0f));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hex), NibblesToHex(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hex + 16), NibblesToHex(_mm_unpackhi_epi8(hi, lo)));
+}
+
+#else
+
+bool ParseHex(const char* hex, uint8_t* bytes) noexcept {
+    return ParseHexScalar(hex, bytes);
+}
+
+void FormatHex(const uint8_t* bytes, char* hex) noexcept {
+    FormatHexScalar(bytes, hex);
+}
+
+#endif
+
+}  // namespace
+
 std::string UUIDToString(const UUIDType& uuid) {
-    return to_string(uuid);
+    std::string str(UUID_TEXT_SIZE, '\0');
+    UUIDToChars(uuid, str.data());
+    return str;
+}
+
+char* UUIDToChars(const UUIDType& uuid, char* out) {
+    char hex[UUID_HEX_SIZE];
+    FormatHex(uuid.data, hex);
+    ScatterHexDigits(hex, out);
+    return out + UUID_TEXT_SIZE;
+}
+
+std::optional<UUIDType> TryUUIDFromString(std::string_view str) noexcept {
+    char hex[UUID_HEX_SIZE];
+    UUIDType uuid;
+    if (!GatherHexDigits(str, hex) || !ParseHex(hex, uuid.data))
+        return std::nullopt;
+    return uuid;
 }
 
 UUIDType UUIDFromString(std::string_view str) {
-    boost::uuids::string_generator gen;
-    return gen(str.begin(), str.end());
+    if (auto uuid = TryUUIDFromString(str))
+        return *uuid;
+    throw std::invalid_argument("Invalid UUID: " + std::string{str});
 }
 
 }  // namespace detail
@@ -1,21 +1,42 @@
 #pragma once
 #include <boost/uuid/nil_generator.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "tagged.h"
 
 namespace util {
 
+enum class UUIDVersion {
+    // Version 4, fully random
+    Random,
+    // Version 7, led by a millisecond timestamp so new keys land at the right edge of an index
+    TimeOrdered,
+};
+
+// Selects the kind of ids TaggedUUID::New produces, process-wide
+void SetUUIDVersion(UUIDVersion version) noexcept;
+UUIDVersion GetUUIDVersion() noexcept;
+
 namespace detail {
 
 using UUIDType = boost::uuids::uuid;
 
 UUIDType NewUUID();
+UUIDType NewRandomUUID();
+UUIDType NewTimeOrderedUUID();
 constexpr UUIDType ZeroUUID{{0}};
 
+constexpr size_t UUID_TEXT_SIZE = 36;
+
 std::string UUIDToString(const UUIDType& uuid);
+// Writes the canonical 36-character form without allocating; returns the end of the written text
+char* UUIDToChars(const UUIDType& uuid, char* out);
+// Both parsers accept only the canonical 8-4-4-4-12 form, in either case
 UUIDType UUIDFromString(std::string_view str);
+std::optional<UUIDType> TryUUIDFromString(std::string_view str) noexcept;
 
 }  // namespace detail
 
@@ -33,10 +54,16 @@ public:
         return TaggedUUID{detail::NewUUID()};
     }
 
-    static TaggedUUID FromString(const std::string& uuid_as_text) {
+    static TaggedUUID FromString(std::string_view uuid_as_text) {
         return TaggedUUID{detail::UUIDFromString(uuid_as_text)};
     }
 
+    static std::optional<TaggedUUID> TryFromString(std::string_view uuid_as_text) noexcept {
+        if (auto uuid = detail::TryUUIDFromString(uuid_as_text))
+            return TaggedUUID{*uuid};
+        return std::nullopt;
+    }
+
     std::string ToString() const {
         return detail::UUIDToString(**this);
     }
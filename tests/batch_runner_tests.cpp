@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/batch_runner.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Counts how units of work end; the commands under test never open one
+class FakeUnitOfWorkFactory : public app::UnitOfWorkFactory {
+public:
+    std::unique_ptr<app::UnitOfWork>& GetUnitOfWork() override {
+        return unit_;
+    }
+    std::unique_ptr<app::UnitOfWork>& GetReadOnlyUnitOfWork() override {
+        return unit_;
+    }
+    void CommitUnitOfWork() override {
+        ++commits;
+    }
+    void ResetUnitOfWork() override {
+        ++resets;
+    }
+    void DeleteUnitOfWork() override {}
+
+    size_t commits = 0;
+    size_t resets = 0;
+
+private:
+    std::unique_ptr<app::UnitOfWork> unit_;
+};
+
+struct BatchFixture {
+    BatchFixture() {
+        menu.AddAction("Ok"s, {}, {}, [this](menu::CommandArgs) {
+            use_cases.EndTransaction();
+            return true;
+        });
+        menu.AddAction("Cancel"s, {}, {}, [this](menu::CommandArgs) {
+            use_cases.CancelTransaction();
+            return true;
+        });
+        menu.AddAction("Throw"s, {}, {}, [](menu::CommandArgs) -> bool {
+            throw std::runtime_error("failed");
+        });
+        menu.AddAction("Ask"s, {}, {}, [this](menu::CommandArgs) {
+            std::string answer;
+            std::getline(script, answer);
+            answers.push_back(answer);
+            use_cases.EndTransaction();
+            return true;
+        });
+    }
+
+    ui::BatchReport Run(std::string text, ui::ErrorPolicy policy = ui::ErrorPolicy::Stop) {
+        script.str(std::move(text));
+        return ui::BatchRunner{menu, use_cases, script, log, policy}.Run();
+    }
+
+    FakeUnitOfWorkFactory factory;
+    app::UseCasesImpl use_cases{&factory};
+    std::istringstream script;
+    std::ostringstream output;
+    std::ostringstream log;
+    menu::Menu menu{script, output};
+    std::vector<std::string> answers;
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(BatchFixture, "Batch commands outside blocks commit one by one") {
+    auto report = Run("# comment\nOk\n\nAsk\n  the answer\nOk\n");
+    CHECK(report.commands == 3);
+    CHECK(report.failed == 0);
+    CHECK(factory.commits == 3);
+    CHECK(answers == std::vector{"  the answer"s});
+}
+
+TEST_CASE_METHOD(BatchFixture, "Begin/Commit block commits once") {
+    auto report = Run("Begin\nOk\nAsk\nyes\nOk\nCommit\nOk\n");
+    CHECK(report.commands == 4);
+    CHECK(report.committed_batches == 1);
+    CHECK(factory.commits == 2);
+    CHECK(factory.resets == 0);
+}
+
+TEST_CASE_METHOD(BatchFixture, "Rollback discards the block") {
+    auto report = Run("Begin\nOk\nOk\nRollback\n");
+    CHECK(report.rolled_back_batches == 1);
+    CHECK(factory.commits == 0);
+    CHECK(factory.resets == 1);
+}
+
+TEST_CASE_METHOD(BatchFixture, "Failed command stops the script by default") {
+    auto report = Run("Ok\nBegin\nOk\nCancel\nOk\nCommit\nOk\n");
+    CHECK(report.commands == 3);
+    CHECK(report.failed == 1);
+    CHECK(report.rolled_back_batches == 1);
+    CHECK(factory.commits == 1);
+    CHECK(log.str().find("FAILED Cancel") != std::string::npos);
+}
+
+TEST_CASE_METHOD(BatchFixture, "Failed block is skipped when continuing on errors") {
+    auto report = Run("Begin\nOk\nThrow\nOk\nCommit\nUnknown\nOk\n", ui::ErrorPolicy::Continue);
+    CHECK(report.commands == 4);
+    CHECK(report.failed == 2);
+    CHECK(report.skipped == 1);
+    CHECK(report.committed_batches == 0);
+    CHECK(factory.commits == 1);
+}
+
+TEST_CASE_METHOD(BatchFixture, "Unterminated block is rolled back") {
+    auto report = Run("Begin\nOk\n");
+    CHECK(report.rolled_back_batches == 1);
+    CHECK(factory.commits == 0);
+    CHECK_THROWS_AS(use_cases.CommitBatch(), std::logic_error);
+}
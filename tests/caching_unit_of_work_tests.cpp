@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/app/caching_unit_of_work.h"
+#include "fake_unit_of_work.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+    FakeCatalog db;
+    app::AuthorCache cache{100, 4};
+
+    app::CachingUnitOfWork MakeUnit(app::ReadSource source = app::ReadSource::Primary) {
+        return app::CachingUnitOfWork{std::make_unique<FakeUnitOfWork>(db), cache, source};
+    }
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Author lookups are served from the cache once loaded") {
+    auto author_id = MakeUnit().AddAuthor("Leo Tolstoy");
+    REQUIRE(author_id.has_value());
+
+    auto uow = MakeUnit();
+    CHECK(uow.FindAuthorById(*author_id)->name == "Leo Tolstoy");
+    CHECK(db.lookups == 1);
+    CHECK(uow.FindAuthorById(*author_id)->name == "Leo Tolstoy");
+    CHECK(uow.FindAuthorByName("Leo Tolstoy")->id == *author_id);
+    CHECK(MakeUnit().FindAuthorById(*author_id).has_value());
+    CHECK(db.lookups == 1);
+    CHECK(cache.GetHits() == 3);
+    CHECK(cache.GetMisses() == 1);
+}
+
+TEST_CASE_METHOD(Fixture, "Author changes invalidate the cache on commit only") {
+    auto author_id = MakeUnit().AddAuthor("Leo Tolstoy");
+    REQUIRE(author_id.has_value());
+    MakeUnit().FindAuthorById(*author_id);
+
+    auto writer = MakeUnit();
+    writer.EditAuthor(*author_id, "Lev Tolstoy");
+    // The writer sees its own change while other units keep reading the committed name
+    CHECK(writer.FindAuthorById(*author_id)->name == "Lev Tolstoy");
+    CHECK(MakeUnit().FindAuthorById(*author_id)->name == "Leo Tolstoy");
+
+    writer.Reset();
+    CHECK(cache.FindName(*author_id) == "Leo Tolstoy"s);
+
+    writer.EditAuthor(*author_id, "Lev Tolstoy");
+    writer.Commit();
+    CHECK_FALSE(cache.FindName(*author_id).has_value());
+    CHECK_FALSE(cache.FindId("Leo Tolstoy").has_value());
+    CHECK(MakeUnit().FindAuthorById(*author_id)->name == "Lev Tolstoy");
+
+    auto deleter = MakeUnit();
+    deleter.DeleteAuthor(*author_id);
+    deleter.Commit();
+    CHECK_FALSE(MakeUnit().FindAuthorById(*author_id).has_value());
+    CHECK_FALSE(MakeUnit().FindAuthorByName("Lev Tolstoy").has_value());
+}
+
+TEST_CASE_METHOD(Fixture, "Units that began before an invalidation do not fill the cache") {
+    auto author_id = MakeUnit().AddAuthor("Leo Tolstoy");
+    REQUIRE(author_id.has_value());
+
+    // Its snapshot may predate the edit below, so what it reads must not outlive it
+    auto reader = MakeUnit();
+    auto writer = MakeUnit();
+    writer.EditAuthor(*author_id, "Lev Tolstoy");
+    writer.Commit();
+    CHECK(reader.FindAuthorById(*author_id).has_value());
+    CHECK_FALSE(cache.FindName(*author_id).has_value());
+
+    MakeUnit().FindAuthorById(*author_id);
+    CHECK(cache.FindName(*author_id) == "Lev Tolstoy"s);
+    CHECK_FALSE(cache.Put(*author_id, "Leo Tolstoy", cache.GetGeneration() - 1));
+    CHECK(cache.FindName(*author_id) == "Lev Tolstoy"s);
+}
+
+TEST_CASE_METHOD(Fixture, "Replica units use the cache without filling it") {
+    auto author_id = MakeUnit().AddAuthor("Leo Tolstoy");
+    REQUIRE(author_id.has_value());
+
+    CHECK(MakeUnit(app::ReadSource::Replica).FindAuthorById(*author_id).has_value());
+    CHECK_FALSE(cache.FindName(*author_id).has_value());
+
+    MakeUnit().FindAuthorById(*author_id);
+    const auto lookups = db.lookups;
+    CHECK(MakeUnit(app::ReadSource::Replica).FindAuthorByName("Leo Tolstoy")->id == *author_id);
+    CHECK(db.lookups == lookups);
+}
+
+TEST_CASE("LRU cache evicts the least recently used entry") {
+    util::ShardedLruCache<int, std::string> cache{2, 1};
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    CHECK(cache.Get(1) == "one"s);
+    cache.Put(3, "three");
+    CHECK(cache.Get(1).has_value());
+    CHECK_FALSE(cache.Get(2).has_value());
+    CHECK(cache.Get(3) == "three"s);
+    CHECK(cache.Size() == 2);
+
+    cache.EraseIf([](int key, const std::string&) {
+        return key == 3;
+    });
+    CHECK(cache.Size() == 1);
+}
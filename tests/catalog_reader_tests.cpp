@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+#include "../src/bulk/catalog_reader.h"
+
+using namespace std::literals;
+
+TEST_CASE("CSV catalog records") {
+    std::istringstream input{
+        "title,author,year,tags\n"
+        "The Idiot,Fyodor Dostoevsky,1869,novel; classic;novel\n"
+        "\n"
+        "\"War, and Peace\",\"Leo \"\"Lev\"\" Tolstoy\",1869\n"};
+    bulk::CatalogReader reader{input, bulk::CatalogFormat::Csv};
+
+    auto first = reader.Next();
+    REQUIRE(first.has_value());
+    CHECK(first->title == "The Idiot"s);
+    CHECK(first->author_name == "Fyodor Dostoevsky"s);
+    CHECK(first->publication_year == 1869);
+    CHECK(first->tags == std::vector{"classic"s, "novel"s});
+
+    auto second = reader.Next();
+    REQUIRE(second.has_value());
+    CHECK(second->title == "War, and Peace"s);
+    CHECK(second->author_name == "Leo \"Lev\" Tolstoy"s);
+    CHECK(second->tags.empty());
+
+    CHECK_FALSE(reader.Next().has_value());
+    CHECK(reader.GetRecordCount() == 2);
+}
+
+TEST_CASE("JSON lines catalog records") {
+    std::istringstream input{
+        R"({"title": "Dune", "author": "Frank Herbert", "year": 1965, "tags": ["sci-fi"]})"
+        "\n"
+        R"({"title": "Dune", "author": "Frank Herbert"})"
+        "\n"};
+    bulk::CatalogReader reader{input, bulk::CatalogFormat::JsonLines};
+
+    auto first = reader.Next();
+    REQUIRE(first.has_value());
+    CHECK(first->title == "Dune"s);
+    CHECK(first->publication_year == 1965);
+    CHECK(first->tags == std::vector{"sci-fi"s});
+
+    CHECK_THROWS_AS(reader.Next(), bulk::CatalogParseError);
+}
+
+TEST_CASE("Catalog format is chosen by extension") {
+    CHECK(bulk::FormatFromPath("books.csv") == bulk::CatalogFormat::Csv);
+    CHECK(bulk::FormatFromPath("books.jsonl") == bulk::CatalogFormat::JsonLines);
+    CHECK_THROWS(bulk::FormatFromPath("books.xml"));
+}
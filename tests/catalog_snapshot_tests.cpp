@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/app/catalog_snapshot.h"
+#include "fake_unit_of_work.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> Titles(const std::vector<items::BookInfo>& books) {
+    std::vector<std::string> titles;
+    for (const auto& book: books)
+        titles.push_back(book.title + " / "s + book.author_name);
+    return titles;
+}
+
+struct Fixture {
+    domain::AuthorId tolstoy = domain::AuthorId::New();
+    domain::AuthorId austen = domain::AuthorId::New();
+    domain::AuthorId unread = domain::AuthorId::New();
+    domain::BookId war_and_peace = domain::BookId::New();
+    domain::BookId emma = domain::BookId::New();
+    domain::BookId emma_tolstoy = domain::BookId::New();
+    domain::BookId anna = domain::BookId::New();
+    FakeCatalog catalog;
+
+    Fixture() {
+        catalog.authors.emplace_back(tolstoy, "leo Tolstoy"s);
+        catalog.authors.emplace_back(austen, "Jane Austen"s);
+        catalog.authors.emplace_back(unread, "Nobody"s);
+        catalog.books.emplace_back("War and Peace"s, war_and_peace, tolstoy, "leo Tolstoy"s, 1869);
+        catalog.books.emplace_back("Emma"s, emma_tolstoy, tolstoy, "leo Tolstoy"s, 1900);
+        catalog.books.emplace_back("Emma"s, emma, austen, "Jane Austen"s, 1815);
+        catalog.books.emplace_back("Anna Karenina"s, anna, tolstoy, "leo Tolstoy"s, 1878);
+        catalog.tags = {{anna, "classic"s}, {war_and_peace, "war"s}, {anna, "romance"s}, {war_and_peace, "classic"s}};
+    }
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Catalog snapshot answers listings and lookups from memory") {
+    FakeUnitOfWork loader{catalog};
+    auto snapshot = app::CatalogSnapshot::Load(loader);
+    CHECK(snapshot->BookCount() == 4);
+    CHECK(snapshot->AuthorCount() == 3);
+
+    const std::vector expected_books{"Anna Karenina / leo Tolstoy"s, "Emma / Jane Austen"s, "Emma / leo Tolstoy"s,
+                                     "War and Peace / leo Tolstoy"s};
+    CHECK(Titles(snapshot->GetBooks()) == expected_books);
+    std::vector<items::BookInfo> visited;
+    snapshot->ForEachBook([&visited](const items::BookInfo& book) {
+        visited.push_back(book);
+    });
+    CHECK(Titles(visited) == expected_books);
+
+    auto tolstoy_books = snapshot->GetAuthorBooks(tolstoy);
+    CHECK(Titles(tolstoy_books)
+          == std::vector{"War and Peace / leo Tolstoy"s, "Anna Karenina / leo Tolstoy"s, "Emma / leo Tolstoy"s});
+    CHECK(tolstoy_books.front().id == war_and_peace);
+    CHECK(tolstoy_books.front().author_id == tolstoy);
+    CHECK(tolstoy_books.front().publication_year == 1869);
+    CHECK(snapshot->GetAuthorBooks(unread).empty());
+    CHECK(snapshot->GetAuthorBooks(domain::AuthorId::New()).empty());
+
+    CHECK(Titles(snapshot->FindBookByTitle("Emma")) == std::vector{"Emma / Jane Austen"s, "Emma / leo Tolstoy"s});
+    CHECK(snapshot->FindBookByTitle("Em").empty());
+
+    CHECK(snapshot->GetBookTags(anna) == std::vector{"classic"s, "romance"s});
+    CHECK(snapshot->GetBookTags(war_and_peace) == std::vector{"war"s, "classic"s});
+    CHECK(snapshot->GetBookTags(emma).empty());
+    CHECK(snapshot->GetBookTags(domain::BookId::New()).empty());
+}
+
+TEST_CASE_METHOD(Fixture, "Snapshot is shared until a unit of work commits changes") {
+    app::CatalogSnapshotStore store;
+    auto make_unit = [this, &store] {
+        return app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store};
+    };
+
+    CHECK(make_unit().GetBooks().size() == 4);
+    CHECK(make_unit().FindBookByTitle("Emma").size() == 2);
+    CHECK(catalog.scans == 1);
+
+    auto writer = make_unit();
+    writer.DeleteBook(anna);
+    // The writer reads its own change while other units keep the committed snapshot
+    CHECK(writer.GetBooks().size() == 3);
+    CHECK(make_unit().GetBooks().size() == 4);
+    CHECK(catalog.scans == 2);
+
+    writer.Commit();
+    CHECK(make_unit().GetBooks().size() == 3);
+    CHECK(make_unit().GetAuthorBooks(tolstoy).size() == 2);
+    CHECK(catalog.scans == 3);
+}
+
+TEST_CASE_METHOD(Fixture, "Snapshot loaded before an invalidation is not kept") {
+    app::CatalogSnapshotStore store;
+    app::SnapshotUnitOfWork reader{std::make_unique<FakeUnitOfWork>(catalog), store};
+    store.Invalidate();
+
+    CHECK(reader.GetBooks().size() == 4);
+    CHECK(reader.GetBooks().size() == 4);
+    CHECK(catalog.scans == 1);
+    app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store}.GetBooks();
+    CHECK(catalog.scans == 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Read-write units use the current snapshot without loading one") {
+    app::CatalogSnapshotStore store;
+    auto make_writer = [this, &store] {
+        return app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store,
+                                       app::SnapshotLoading::UseCurrent};
+    };
+
+    CHECK(make_writer().GetBooks().size() == 4);
+    CHECK(catalog.scans == 1);
+    CHECK(store.Find() == nullptr);
+
+    app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store}.GetBooks();
+    CHECK(catalog.scans == 2);
+    CHECK(make_writer().GetBooks().size() == 4);
+    CHECK(catalog.scans == 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Replica units read through instead of loading the snapshot") {
+    app::CatalogSnapshotStore store;
+    auto writer = app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store};
+    writer.DeleteBook(anna);
+    writer.Commit();
+
+    // A lagging replica may still return the deleted book, so its rows must not become the snapshot
+    FakeCatalog replica = catalog;
+    replica.books.emplace_back("Anna Karenina"s, anna, tolstoy, "leo Tolstoy"s, 1878);
+    auto make_replica_unit = [&store, &replica] {
+        return app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(replica), store, app::SnapshotLoading::Load,
+                                       app::ReadSource::Replica};
+    };
+    CHECK(make_replica_unit().GetBooks().size() == 4);
+    CHECK(store.Find() == nullptr);
+
+    CHECK(app::SnapshotUnitOfWork{std::make_unique<FakeUnitOfWork>(catalog), store}.GetBooks().size() == 3);
+    CHECK(catalog.scans == 1);
+    CHECK(make_replica_unit().GetBooks().size() == 3);
+    CHECK(replica.scans == 1);
+}
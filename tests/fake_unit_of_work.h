@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/app/use_cases.h"
+
+// Catalog shared by every fake unit, standing in for the database
+struct FakeCatalog {
+    std::vector<items::AuthorInfo> authors;
+    std::vector<items::BookInfo> books;
+    std::vector<std::pair<domain::BookId, std::string>> tags;
+    // Full book scans and single author lookups served so far
+    size_t scans = 0;
+    size_t lookups = 0;
+};
+
+// Applies changes to the catalog right away; Commit and Reset do nothing
+class FakeUnitOfWork : public app::UnitOfWork {
+public:
+    explicit FakeUnitOfWork(FakeCatalog& catalog): catalog_{catalog} {}
+
+    std::optional<domain::AuthorId> AddAuthor(const std::string& name) override {
+        auto author_id = domain::AuthorId::New();
+        catalog_.authors.emplace_back(author_id, std::string{name});
+        return author_id;
+    }
+    std::optional<domain::BookId> AddBook(const std::string&, size_t, const domain::AuthorId&) override {
+        return std::nullopt;
+    }
+    void AddBookTags(const domain::BookId&, const std::vector<std::string>&) override {}
+    std::vector<items::AuthorInfo> GetAuthors() override {
+        return catalog_.authors;
+    }
+    std::vector<items::BookInfo> GetBooks() override {
+        ++catalog_.scans;
+        return catalog_.books;
+    }
+    void ForEachBook(const app::BookVisitor& visitor) override {
+        ++catalog_.scans;
+        for (const auto& book: catalog_.books)
+            visitor(book);
+    }
+    void ForEachBookTag(const app::BookTagVisitor& visitor) override {
+        for (auto [book_id, tag]: catalog_.tags)
+            visitor(book_id, std::move(tag));
+    }
+    items::Page<items::AuthorInfo> GetAuthorsPage(const std::optional<items::AuthorInfo>&, size_t) override {
+        return {};
+    }
+    items::Page<items::BookInfo> GetBooksPage(const std::optional<items::BookInfo>&, size_t) override {
+        return {};
+    }
+    std::vector<items::BookInfo> GetAuthorBooks(const domain::AuthorId&) override {
+        return {};
+    }
+    std::optional<items::AuthorInfo> FindAuthorByName(const std::string& author_name) override {
+        ++catalog_.lookups;
+        return FindAuthor([&author_name](const items::AuthorInfo& author) {
+            return author.name == author_name;
+        });
+    }
+    std::vector<items::BookInfo> FindBookByTitle(const std::string&) override {
+        return {};
+    }
+    std::vector<items::BookDetails> FindBookDetailsByTitle(const std::string&) override {
+        return {};
+    }
+    std::vector<items::BookInfo> SearchBooks(const std::string&, size_t) override {
+        return {};
+    }
+    void DeleteAuthor(const domain::AuthorId& author_id) override {
+        std::erase_if(catalog_.authors, [&author_id](const items::AuthorInfo& author) {
+            return author.id == author_id;
+        });
+    }
+    void EditAuthor(const domain::AuthorId& author_id, const std::string& new_author_name) override {
+        for (auto& author: catalog_.authors) {
+            if (author.id == author_id)
+                author.name = new_author_name;
+        }
+    }
+    void DeleteBook(const domain::BookId& book_id) override {
+        std::erase_if(catalog_.books, [&book_id](const items::BookInfo& book) {
+            return book.id == book_id;
+        });
+    }
+    void EditBook(const items::BookInfo&) override {}
+    std::optional<items::AuthorInfo> GetBookAuthor(const domain::BookId&) override {
+        return std::nullopt;
+    }
+    std::optional<items::AuthorInfo> FindAuthorById(const domain::AuthorId& author_id) override {
+        ++catalog_.lookups;
+        return FindAuthor([&author_id](const items::AuthorInfo& author) {
+            return author.id == author_id;
+        });
+    }
+    std::vector<std::string> GetBookTags(const domain::BookId&) override {
+        return {};
+    }
+    void EditBookTags(const domain::BookId&, const std::vector<std::string>&) override {}
+    void Commit() override {}
+    void Reset() override {}
+
+private:
+    template <typename Predicate>
+    std::optional<items::AuthorInfo> FindAuthor(Predicate predicate) const {
+        auto it = std::ranges::find_if(catalog_.authors, predicate);
+        if (it == catalog_.authors.end())
+            return std::nullopt;
+        return items::AuthorInfo{it->id, std::string{it->name}};
+    }
+
+    FakeCatalog& catalog_;
+};
@@ -0,0 +1,117 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "../src/app/listing_order.h"
+
+using namespace std::literals;
+
+namespace {
+
+items::BookInfo MakeBook(std::string title, std::string author_name) {
+    return {std::move(title), domain::BookId::New(), domain::AuthorId::New(), std::move(author_name), 2000};
+}
+
+std::vector<std::string> Rows(const std::vector<items::BookInfo>& books) {
+    std::vector<std::string> rows;
+    for (const auto& book: books)
+        rows.push_back(book.title + " / "s + book.author_name);
+    return rows;
+}
+
+std::vector<items::BookInfo> MakeRandomBooks(size_t count, std::mt19937& random) {
+    auto random_word = [&random] {
+        std::string word(3 + random() % 8, ' ');
+        for (auto& c: word)
+            c = static_cast<char>((random() % 2 ? 'a' : 'A') + random() % 26);
+        return word;
+    };
+    std::vector<items::BookInfo> books;
+    books.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        books.push_back(MakeBook(random_word() + " "s + random_word(), random_word() + " "s + random_word()));
+    return books;
+}
+
+// Order of the listings before the shared sort, kept for comparison
+void SortBooksWithComparator(std::vector<items::BookInfo>& books) {
+    std::sort(books.begin(), books.end(), [](auto& l, auto& r) {
+        if (l.title == r.title) {
+            char new_c_l = std::tolower(l.author_name[0]), new_c_r = std::tolower(r.author_name[0]);
+            std::string new_name_l, new_name_r;
+            new_name_l += new_c_l;
+            new_name_l += l.author_name.substr(1);
+            new_name_r += new_c_r;
+            new_name_r += r.author_name.substr(1);
+            return new_name_l < new_name_r;
+        }
+        return l.title < r.title;
+    });
+}
+
+}  // namespace
+
+TEST_CASE("Books are sorted by title, then by case-folded author name") {
+    std::vector books{MakeBook("Emma"s, "jane Austen"s), MakeBook("Emma Two"s, "B"s), MakeBook("Emma"s, "Anonymous"s),
+                      MakeBook("Emm"s, "Z"s), MakeBook("Emma"s, "JANE AUSTEN"s), MakeBook("emma"s, "A"s),
+                      MakeBook("Emma"s, "Jane Austen"s)};
+    auto first_twin = books[0].id;
+    app::SortBooks(books);
+    CHECK(Rows(books)
+          == std::vector{"Emm / Z"s, "Emma / Anonymous"s, "Emma / jane Austen"s, "Emma / JANE AUSTEN"s,
+                         "Emma / Jane Austen"s, "Emma Two / B"s, "emma / A"s});
+    // Rows with equal keys keep their order
+    CHECK(books[2].id == first_twin);
+}
+
+TEST_CASE("Parallel and sequential sorts agree") {
+    std::mt19937 random{7};
+    auto books = MakeRandomBooks(app::PARALLEL_SORT_THRESHOLD * 2, random);
+    // Duplicate titles with authors differing in case exercise the tie-breaks
+    for (size_t i = 0; i < books.size(); i += 3)
+        books[i].title = books[i / 2].title;
+
+    app::BookSortKeys keys;
+    for (const auto& book: books)
+        keys.Add(book.title, book.author_name);
+    auto order = keys.SortedPermutation();
+
+    std::vector<uint32_t> expected(keys.Size());
+    std::iota(expected.begin(), expected.end(), uint32_t{0});
+    std::stable_sort(expected.begin(), expected.end(), [&keys](uint32_t l, uint32_t r) {
+        return keys.Key(l) < keys.Key(r);
+    });
+    CHECK(order == expected);
+
+    auto sorted = books;
+    app::SortBooks(sorted);
+    auto by_comparator = books;
+    SortBooksWithComparator(by_comparator);
+    // The old comparator folded only the first letter of the name, so compare titles only
+    CHECK(std::equal(sorted.begin(), sorted.end(), by_comparator.begin(), by_comparator.end(),
+                     [](const auto& l, const auto& r) {
+                         return l.title == r.title;
+                     }));
+}
+
+TEST_CASE("Book listing sort throughput", "[.][benchmark]") {
+    std::mt19937 random{42};
+    auto books = MakeRandomBooks(100'000, random);
+    // Editions and translations share titles
+    for (size_t i = 0; i < books.size(); i += 4)
+        books[i].title = books[random() % books.size()].title;
+
+    BENCHMARK("Comparator building strings per comparison") {
+        auto copy = books;
+        SortBooksWithComparator(copy);
+        return copy.front().title.size();
+    };
+    BENCHMARK("Precomputed keys, permutation sort") {
+        auto copy = books;
+        app::SortBooks(copy);
+        return copy.front().title.size();
+    };
+}
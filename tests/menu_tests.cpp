@@ -0,0 +1,93 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/menu/menu.h"
+
+using namespace std::literals;
+
+TEST_CASE("Command arguments are read without copying") {
+    menu::CommandArgs args{"  1869\tWar and Peace  \n"sv};
+    int year = 0;
+    CHECK(args.Next(year));
+    CHECK(year == 1869);
+    CHECK(args.Rest() == "War and Peace"sv);
+    CHECK(args.NextToken() == "War"sv);
+    CHECK(args.NextToken() == "and"sv);
+    CHECK(args.NextToken() == "Peace"sv);
+    CHECK(args.NextToken().empty());
+    CHECK(args.Rest().empty());
+
+    menu::CommandArgs text{" War and Peace"sv};
+    year = 1;
+    CHECK_FALSE(text.Next(year));
+    CHECK(year == 0);
+    CHECK(text.Rest() == "War and Peace"sv);
+}
+
+TEST_CASE("Menu dispatches commands by name") {
+    std::istringstream input{"ShowBooks\n  AddAuthor   Leo Tolstoy \nShowAuthors\n\nExit\nShowBooks\n"s};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    std::vector<std::string> calls;
+    menu.AddAction("AddAuthor"s, "name"s, "Adds author"s, [&calls](menu::CommandArgs args) {
+        calls.emplace_back(args.Rest());
+        return true;
+    });
+    menu.AddAction("ShowBooks"s, {}, "Show books"s, [&calls](menu::CommandArgs) {
+        calls.emplace_back("ShowBooks"s);
+        return true;
+    });
+    menu.AddAction("Exit"s, {}, "Exit program"s, [](menu::CommandArgs) {
+        return false;
+    });
+
+    menu.Run();
+    CHECK(calls == std::vector{"ShowBooks"s, "Leo Tolstoy"s});
+    CHECK(output.str() == "Command 'ShowAuthors' has not been found.\nInvalid command\n");
+}
+
+TEST_CASE("Menu reports failed commands") {
+    std::istringstream input;
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    menu.AddAction("Throw"s, {}, {}, [](menu::CommandArgs) -> bool {
+        throw std::runtime_error("failed");
+    });
+    CHECK(menu.Execute("Throw"sv) == menu::Menu::Result::Failed);
+    CHECK(menu.Execute("Unknown"sv) == menu::Menu::Result::Failed);
+    CHECK(menu.Execute("   "sv) == menu::Menu::Result::Failed);
+
+    // Actions added after the first dispatch are found as well
+    menu.AddAction("Continue"s, {}, {}, [](menu::CommandArgs) {
+        return true;
+    });
+    CHECK(menu.Execute("Continue"sv) == menu::Menu::Result::Continue);
+    CHECK_THROWS_AS(menu.AddAction("Continue"s, {}, {}, {}), std::invalid_argument);
+}
+
+TEST_CASE("Menu dispatch throughput", "[.][benchmark]") {
+    constexpr int COMMANDS = 1'000'000;
+    const std::vector<std::string> lines{"ShowBooks"s, "AddBook 1869 War and Peace"s, "ShowBook Anna Karenina"s,
+                                         "DeleteAuthor Leo Tolstoy"s, "Search peace"s};
+    std::istringstream input;
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    size_t arg_bytes = 0;
+    for (auto name : {"AddAuthor"s, "AddBook"s, "ShowAuthors"s, "ShowBooks"s, "ShowAuthorBooks"s, "DeleteAuthor"s,
+                      "EditAuthor"s, "ShowBook"s, "DeleteBook"s, "EditBook"s, "Search"s}) {
+        menu.AddAction(std::move(name), {}, {}, [&arg_bytes](menu::CommandArgs args) {
+            arg_bytes += args.Rest().size();
+            return true;
+        });
+    }
+
+    BENCHMARK("Menu::Execute") {
+        for (int i = 0; i < COMMANDS; ++i)
+            menu.Execute(lines[i % lines.size()]);
+        return arg_bytes;
+    };
+}
@@ -0,0 +1,59 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "../src/ui/output_buffer.h"
+
+using namespace std::literals;
+
+TEST_CASE("Output buffer writes formatted text on flush") {
+    std::ostringstream stream;
+    {
+        ui::OutputBuffer output{stream};
+        output << 1 << ' ' << "War and Peace"sv << " by "s << "Leo Tolstoy" << ", " << 1869 << '\n';
+        output << std::numeric_limits<int64_t>::min() << ' ' << std::numeric_limits<uint64_t>::max() << '\n';
+        CHECK(stream.str().empty());
+        output.Flush();
+        CHECK(stream.str() == "1 War and Peace by Leo Tolstoy, 1869\n-9223372036854775808 18446744073709551615\n");
+        output << "unflushed";
+    }
+    CHECK(stream.str().ends_with("unflushed"));
+}
+
+TEST_CASE("Output buffer drains in order when full") {
+    std::ostringstream stream;
+    ui::OutputBuffer output{stream, 8};
+    output << "abcde" << "fgh" << 'i';
+    CHECK(stream.str() == "abcdefgh");
+    output << "a text longer than the buffer"sv;
+    CHECK(stream.str() == "abcdefghia text longer than the buffer");
+    output << 12345 << 678;
+    output.Flush();
+    CHECK(stream.str() == "abcdefghia text longer than the buffer12345678");
+}
+
+TEST_CASE("Book listing output throughput", "[.][benchmark]") {
+    constexpr int ROWS = 1'000'000;
+    const auto path = std::filesystem::temp_directory_path() / "bookypedia_listing_benchmark.txt";
+
+    BENCHMARK("std::ostream, std::endl per row") {
+        std::ofstream file{path};
+        for (int i = 1; i <= ROWS; ++i)
+            file << i << " " << "War and Peace" << " by " << "Leo Tolstoy" << ", " << 1869 << std::endl;
+        return file.tellp();
+    };
+    BENCHMARK("OutputBuffer, one flush") {
+        std::ofstream file{path};
+        ui::OutputBuffer output{file};
+        for (int i = 1; i <= ROWS; ++i)
+            output << i << ' ' << "War and Peace"sv << " by "sv << "Leo Tolstoy"sv << ", "sv << 1869 << '\n';
+        output.Flush();
+        return file.tellp();
+    };
+    std::filesystem::remove(path);
+}
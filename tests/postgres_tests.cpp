@@ -0,0 +1,422 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include "../src/postgres/async_unit_of_work.h"
+#include "../src/postgres/migrations.h"
+#include "../src/postgres/postgres.h"
+#include "../src/postgres/rows.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr const char TEST_DB_URL_ENV_NAME[]{"BOOKYPEDIA_TEST_DB_URL"};
+
+// Tests run only when a scratch database is configured; every unit of work is rolled back
+struct DatabaseFixture {
+    std::optional<postgres::Database> db;
+
+    DatabaseFixture() {
+        if (const auto* url = std::getenv(TEST_DB_URL_ENV_NAME))
+            db.emplace(postgres::ConnectionPoolConfig{url});
+    }
+
+    static std::string UniqueName(std::string_view prefix) {
+        return std::string{prefix} + " " + domain::AuthorId::New().ToString();
+    }
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(DatabaseFixture, "Book listings take one round trip") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    postgres::UnitOfWorkImpl uow{db->GetPool().Acquire()};
+    const auto author_name = UniqueName("Author");
+    const auto title = UniqueName("Title");
+    auto author_id = uow.AddAuthor(author_name);
+    REQUIRE(author_id.has_value());
+    std::optional<domain::BookId> book_id;
+    for (int year = 2000; year < 2005; ++year)
+        book_id = uow.AddBook(title, year, *author_id);
+    REQUIRE(book_id.has_value());
+
+    auto before = uow.GetRoundTrips();
+    auto books = uow.FindBookByTitle(title);
+    CHECK(uow.GetRoundTrips() - before == 1);
+    REQUIRE(books.size() == 5);
+    CHECK(books.front().author_name == author_name);
+
+    before = uow.GetRoundTrips();
+    books = uow.GetAuthorBooks(*author_id);
+    CHECK(uow.GetRoundTrips() - before == 1);
+    REQUIRE(books.size() == 5);
+    CHECK(books.front().publication_year == 2000);
+
+    before = uow.GetRoundTrips();
+    books = uow.GetBooks();
+    CHECK(uow.GetRoundTrips() - before == 1);
+    CHECK(books.size() >= 5);
+
+    before = uow.GetRoundTrips();
+    auto author = uow.GetBookAuthor(*book_id);
+    CHECK(uow.GetRoundTrips() - before == 1);
+    REQUIRE(author.has_value());
+    CHECK(author->name == author_name);
+    CHECK(author->id == *author_id);
+    CHECK(books.back().id != domain::BookId{});
+
+    uow.Reset();
+}
+
+TEST_CASE("Connection pool is bounded and reuses returned connections") {
+    const auto* url = std::getenv(TEST_DB_URL_ENV_NAME);
+    if (!url) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    size_t opened = 0;
+    postgres::ConnectionPool pool{postgres::ConnectionPoolConfig{url, 1, 2, std::chrono::milliseconds{50}},
+                                  [url, &opened] {
+                                      ++opened;
+                                      return std::make_unique<pqxx::connection>(url);
+                                  }};
+    CHECK(pool.Size() == 1);
+    {
+        auto first = pool.Acquire();
+        auto second = pool.Acquire();
+        CHECK(pool.Size() == 2);
+        CHECK_THROWS_AS(pool.Acquire(), postgres::ConnectionPoolTimeout);
+    }
+    CHECK(pool.IdleSize() == 2);
+    auto again = pool.Acquire();
+    CHECK(opened == 2);
+}
+
+TEST_CASE("Connection pool replaces connections dropped by the server") {
+    const auto* url = std::getenv(TEST_DB_URL_ENV_NAME);
+    if (!url) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    size_t opened = 0;
+    postgres::ConnectionPool pool{
+            postgres::ConnectionPoolConfig{url, 1, 1, std::chrono::milliseconds{50}, std::chrono::milliseconds{0}},
+            [url, &opened] {
+                ++opened;
+                return std::make_unique<pqxx::connection>(url);
+            }};
+    int backend_pid = 0;
+    {
+        auto connection = pool.Acquire();
+        backend_pid = connection->backend_pid();
+    }
+    pqxx::connection admin{url};
+    pqxx::nontransaction{admin}.exec_params("SELECT pg_terminate_backend($1)", backend_pid);
+
+    auto connection = pool.Acquire();
+    CHECK(opened == 2);
+    CHECK(connection->backend_pid() != backend_pid);
+    CHECK(pqxx::nontransaction{*connection}.query_value<int>("SELECT 1") == 1);
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Book tags are written in one statement") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    postgres::UnitOfWorkImpl uow{db->GetPool().Acquire()};
+    auto author_id = uow.AddAuthor(UniqueName("Author"));
+    REQUIRE(author_id.has_value());
+    auto book_id = uow.AddBook(UniqueName("Title"), 2000, *author_id);
+    REQUIRE(book_id.has_value());
+
+    auto before = uow.GetRoundTrips();
+    uow.AddBookTags(*book_id, {"drama", "novel", "classic"});
+    CHECK(uow.GetRoundTrips() - before == 1);
+
+    before = uow.GetRoundTrips();
+    uow.EditBookTags(*book_id, {"novel", "classic", "russian"});
+    CHECK(uow.GetRoundTrips() - before == 1);
+
+    auto tags = uow.GetBookTags(*book_id);
+    std::sort(tags.begin(), tags.end());
+    CHECK(tags == std::vector<std::string>{"classic", "novel", "russian"});
+
+    // Repeated names map to one dictionary entry, shared between books
+    auto other_book_id = uow.AddBook(UniqueName("Title"), 2001, *author_id);
+    REQUIRE(other_book_id.has_value());
+    const auto rare_tag = "t" + domain::BookId::New().ToString().substr(0, 8);
+    uow.AddBookTags(*other_book_id, {rare_tag, rare_tag, "novel"});
+    uow.EditBookTags(*book_id, {rare_tag, rare_tag});
+    tags = uow.GetBookTags(*other_book_id);
+    std::sort(tags.begin(), tags.end());
+    CHECK(tags == std::vector<std::string>{"novel", rare_tag});
+    CHECK(uow.GetBookTags(*book_id) == std::vector<std::string>{rare_tag});
+
+    uow.Reset();
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Schema is at the latest migration") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    auto connection = db->GetPool().Acquire();
+    CHECK(postgres::ApplyMigrations(*connection) == 0);
+    pqxx::read_transaction read{*connection};
+    CHECK(read.exec1("SELECT max(version) FROM schema_version;")[0].as<int>() == postgres::LatestSchemaVersion());
+}
+
+TEST_CASE("Foreign key migration removes books of missing authors with their tags") {
+    const auto* url = std::getenv(TEST_DB_URL_ENV_NAME);
+    if (!url) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    // The migrations run from scratch in a schema of their own, searched ahead of public where pg_trgm lives.
+    // Its own schema_version table keeps public's from being found.
+    pqxx::connection connection{url};
+    const auto schema = connection.quote_name("migration_test_" + domain::AuthorId::New().ToString());
+    pqxx::nontransaction{connection}.exec("CREATE SCHEMA " + schema + "; SET search_path TO " + schema + R"(, public;
+CREATE TABLE schema_version (version integer PRIMARY KEY, description text NOT NULL, applied_at timestamptz);)");
+    try {
+        CHECK(postgres::ApplyMigrations(connection, 2) == 2);
+        {
+            pqxx::work work{connection};
+            work.exec(R"(
+INSERT INTO authors (id, name) VALUES ('00000000-0000-0000-0000-000000000001', 'Author');
+INSERT INTO books (id, author_id, title, publication_year) VALUES
+    ('00000000-0000-0000-0000-000000000011', '00000000-0000-0000-0000-000000000001', 'Kept', 2000),
+    ('00000000-0000-0000-0000-000000000012', '00000000-0000-0000-0000-000000000002', 'Orphan', 2000);
+INSERT INTO book_tags (book_id, tag) VALUES
+    ('00000000-0000-0000-0000-000000000011', 'kept'),
+    ('00000000-0000-0000-0000-000000000012', 'orphan'),
+    ('00000000-0000-0000-0000-000000000013', 'no book');
+)");
+            work.commit();
+        }
+        CHECK(postgres::ApplyMigrations(connection) == static_cast<size_t>(postgres::LatestSchemaVersion() - 2));
+
+        pqxx::read_transaction read{connection};
+        CHECK(read.query_value<int>("SELECT count(*) FROM books") == 1);
+        CHECK(read.query_value<std::string>("SELECT name FROM tags JOIN book_tags ON tags.id = book_tags.tag_id") ==
+              "kept");
+    } catch (...) {
+        pqxx::nontransaction{connection}.exec("DROP SCHEMA " + schema + " CASCADE");
+        throw;
+    }
+    pqxx::nontransaction{connection}.exec("DROP SCHEMA " + schema + " CASCADE");
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Deletes cascade to books and tags") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    std::vector<domain::BookId> book_ids;
+    {
+        postgres::UnitOfWorkImpl uow{db->GetPool().Acquire()};
+        auto author_id = uow.AddAuthor(UniqueName("Author"));
+        REQUIRE(author_id.has_value());
+        for (int year = 2000; year < 2003; ++year) {
+            auto book_id = uow.AddBook(UniqueName("Title"), year, *author_id);
+            REQUIRE(book_id.has_value());
+            uow.AddBookTags(*book_id, {"first", "second"});
+            book_ids.push_back(*book_id);
+        }
+
+        auto before = uow.GetRoundTrips();
+        uow.DeleteBook(book_ids.front());
+        CHECK(uow.GetRoundTrips() - before == 1);
+        CHECK(uow.GetBookTags(book_ids.front()).empty());
+        CHECK(uow.GetAuthorBooks(*author_id).size() == 2);
+
+        before = uow.GetRoundTrips();
+        uow.DeleteAuthor(*author_id);
+        CHECK(uow.GetRoundTrips() - before == 1);
+        CHECK_FALSE(uow.FindAuthorById(*author_id).has_value());
+
+        // Nothing the test added is left, so it commits and the tables are checked directly;
+        // the unit of work's queries join authors and would not see orphaned rows
+        uow.Commit();
+    }
+    std::string ids;
+    for (const auto& book_id: book_ids)
+        ids += (ids.empty() ? "{" : ",") + book_id.ToString();
+    ids += "}";
+    auto connection = db->GetPool().Acquire();
+    pqxx::read_transaction read{*connection};
+    CHECK(read.exec_params1("SELECT count(*) FROM books WHERE id = ANY($1::uuid[])", ids)[0].as<int>() == 0);
+    CHECK(read.exec_params1("SELECT count(*) FROM book_tags WHERE book_id = ANY($1::uuid[])", ids)[0].as<int>() == 0);
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Book details come with author and tags in one round trip") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    postgres::UnitOfWorkImpl uow{db->GetPool().Acquire()};
+    const auto author_name = UniqueName("Author");
+    const auto title = UniqueName("Title");
+    auto author_id = uow.AddAuthor(author_name);
+    REQUIRE(author_id.has_value());
+    auto tagged_id = uow.AddBook(title, 2000, *author_id);
+    REQUIRE(tagged_id.has_value());
+    uow.AddBookTags(*tagged_id, {"novel", "classic"});
+    REQUIRE(uow.AddBook(title, 2001, *author_id).has_value());
+
+    auto before = uow.GetRoundTrips();
+    auto books = uow.FindBookDetailsByTitle(title);
+    CHECK(uow.GetRoundTrips() - before == 1);
+    REQUIRE(books.size() == 2);
+    for (const auto& details: books) {
+        CHECK(details.book.author_name == author_name);
+        if (details.book.id == *tagged_id)
+            CHECK(details.tags == std::vector<std::string>{"classic", "novel"});
+        else
+            CHECK(details.tags.empty());
+    }
+
+    uow.Reset();
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Search matches prefixes, substrings and typos") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    postgres::UnitOfWorkImpl uow{db->GetPool().Acquire()};
+    // A made-up word no other book in the database can contain
+    auto word = "q"s + domain::BookId::New().ToString().substr(0, 8) + "wood";
+    const auto author_name = UniqueName("Author");
+    auto author_id = uow.AddAuthor(author_name);
+    REQUIRE(author_id.has_value());
+    for (int year = 2000; year < 2003; ++year)
+        REQUIRE(uow.AddBook("The "s + word + " Chronicles", year, *author_id).has_value());
+
+    auto found_all = [&](const std::string& query) {
+        auto books = uow.SearchBooks(query, 10);
+        return std::count_if(books.begin(), books.end(), [&](const items::BookInfo& book) {
+                   return book.author_name == author_name;
+               }) == 3;
+    };
+    CHECK(found_all(word.substr(0, 6)));
+    CHECK(found_all(word.substr(3, 8)));
+    auto typo = word;
+    typo[4] = typo[4] == 'x' ? 'y' : 'x';
+    CHECK(found_all(typo + " chronicles"));
+    CHECK(found_all(author_name.substr(author_name.size() - 12)));
+
+    CHECK(uow.SearchBooks(word, 2).size() == 2);
+    CHECK(uow.SearchBooks("", 10).empty());
+
+    uow.Reset();
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Async units of work share one thread") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    namespace net = boost::asio;
+    const std::string url = std::getenv(TEST_DB_URL_ENV_NAME);
+    const auto author_name = UniqueName("Author");
+    const auto title = UniqueName("Title");
+
+    net::io_context ioc;
+    std::vector<std::vector<items::BookInfo>> found;
+    auto worker = [&](int index) -> net::awaitable<void> {
+        auto connection = co_await postgres::AsyncConnection::Connect(url);
+        postgres::AsyncUnitOfWork uow{*connection};
+        auto author_id = co_await uow.AddAuthor(author_name + std::to_string(index));
+        auto book_id = co_await uow.AddBook(title, 2000, author_id.value_or(domain::AuthorId{}));
+        co_await uow.AddBookTags(book_id.value_or(domain::BookId{}), {"async"});
+        found.push_back(co_await uow.FindBookByTitle(title));
+        co_await uow.Reset();
+    };
+    for (int i = 0; i < 4; ++i)
+        net::co_spawn(ioc, worker(i), [](std::exception_ptr e) {
+            if (e)
+                std::rethrow_exception(e);
+        });
+    ioc.run();
+
+    REQUIRE(found.size() == 4);
+    for (const auto& books: found)
+        CHECK(books.size() == 1);
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Book pages are read through the index without sorting") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    auto connection = db->GetPool().Acquire();
+    pqxx::work work{*connection};
+    // Small test tables would otherwise be scanned whole
+    work.exec("SET LOCAL enable_seqscan = off");
+    std::string plan;
+    for (const auto& row : work.exec("EXPLAIN EXECUTE get_books_page_after('War and Peace', "
+                                     "'00000000-0000-0000-0000-000000000000', 51)"))
+        plan += row[0].as<std::string>() + "\n";
+    CHECK(plan.find("books_title_c_id_idx") != std::string::npos);
+    CHECK(plan.find("Sort") == std::string::npos);
+}
+
+TEST_CASE_METHOD(DatabaseFixture, "Read-only units of work reject writes") {
+    if (!db) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    for (auto mode: {postgres::TransactionMode::ReadOnly, postgres::TransactionMode::ReadOnlySnapshot}) {
+        postgres::UnitOfWorkImpl uow{db->GetPool().Acquire(), mode};
+        CHECK_NOTHROW(uow.GetAuthorsPage(std::nullopt, 1));
+        CHECK_FALSE(uow.AddAuthor(UniqueName("Author")).has_value());
+        uow.Reset();
+    }
+}
+
+TEST_CASE("Reads followed by writes need a single connection without a replica") {
+    const auto* url = std::getenv(TEST_DB_URL_ENV_NAME);
+    if (!url) {
+        WARN(TEST_DB_URL_ENV_NAME + " is not set, skipping"s);
+        return;
+    }
+    postgres::Database db{postgres::ConnectionPoolConfig{url, 1, 1, std::chrono::milliseconds{100}}};
+    postgres::UnitOfWorkFactoryImpl factory{db.GetPool()};
+    const auto name = DatabaseFixture::UniqueName("Author");
+    CHECK_FALSE(factory.GetReadOnlyUnitOfWork()->FindAuthorByName(name).has_value());
+    std::optional<domain::AuthorId> author_id;
+    CHECK_NOTHROW(author_id = factory.GetUnitOfWork()->AddAuthor(name));
+    CHECK(author_id.has_value());
+    // Later reads see the write
+    CHECK(factory.GetReadOnlyUnitOfWork()->FindAuthorByName(name).has_value());
+    factory.ResetUnitOfWork();
+    CHECK(db.GetPool().IdleSize() == 1);
+}
+
+TEST_CASE("Text array literals are parsed into tags") {
+    using postgres::detail::TagsFromArray;
+    CHECK(TagsFromArray("{}").empty());
+    CHECK(TagsFromArray("{classic,\"war and peace\",NULL,\"NULL\"}")
+          == std::vector{"classic"s, "war and peace"s, "NULL"s});
+    CHECK(TagsFromArray(R"({"a \"quoted\" tag","back\\slash",""})")
+          == std::vector{R"(a "quoted" tag)"s, R"(back\slash)"s, ""s});
+}
+
+TEST_CASE("Pages drop the extra row and report that more follow") {
+    auto page = postgres::detail::PageFromItems(std::vector{1, 2, 3}, 2);
+    CHECK(page.items == std::vector{1, 2});
+    CHECK(page.has_more);
+    CHECK_FALSE(postgres::detail::PageFromItems(std::vector{1, 2}, 2).has_more);
+}
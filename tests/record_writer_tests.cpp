@@ -0,0 +1,82 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "../src/ui/record_writer.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::string_view BOOK_COLUMNS[] = {"num"sv, "title"sv, "author"sv, "publication_year"sv};
+
+std::string WriteBooks(ui::OutputFormat format) {
+    std::ostringstream stream;
+    {
+        ui::OutputBuffer output{stream};
+        ui::RecordWriter writer{output, format, BOOK_COLUMNS};
+        writer.Field(1).Field("War and Peace"sv).Field("Leo Tolstoy"sv).Field(1869).EndRecord();
+        writer.Field(2).Field("Say \"Hi\",\tC:\\ \n\x01"sv).Field(""sv).Field(-5).EndRecord();
+    }
+    return stream.str();
+}
+
+}  // namespace
+
+TEST_CASE("JSON Lines records escape strings") {
+    CHECK(WriteBooks(ui::OutputFormat::JsonLines) ==
+          "{\"num\":1,\"title\":\"War and Peace\",\"author\":\"Leo Tolstoy\",\"publication_year\":1869}\n"
+          "{\"num\":2,\"title\":\"Say \\\"Hi\\\",\\tC:\\\\ \\n\\u0001\",\"author\":\"\",\"publication_year\":-5}\n");
+}
+
+TEST_CASE("CSV records quote fields with separators and quotes") {
+    CHECK(WriteBooks(ui::OutputFormat::Csv) ==
+          "num,title,author,publication_year\n"
+          "1,War and Peace,Leo Tolstoy,1869\n"
+          "2,\"Say \"\"Hi\"\",\tC:\\ \n\x01\",,-5\n");
+}
+
+TEST_CASE("TSV records escape tabs, line breaks and backslashes") {
+    CHECK(WriteBooks(ui::OutputFormat::Tsv) ==
+          "num\ttitle\tauthor\tpublication_year\n"
+          "1\tWar and Peace\tLeo Tolstoy\t1869\n"
+          "2\tSay \"Hi\",\\tC:\\\\ \\n\x01\t\t-5\n");
+}
+
+TEST_CASE("Output formats are parsed by name") {
+    CHECK(ui::ParseOutputFormat("text"sv) == ui::OutputFormat::Text);
+    CHECK(ui::ParseOutputFormat("jsonl"sv) == ui::OutputFormat::JsonLines);
+    CHECK(ui::ParseOutputFormat("csv"sv) == ui::OutputFormat::Csv);
+    CHECK(ui::ParseOutputFormat("tsv"sv) == ui::OutputFormat::Tsv);
+    CHECK_THROWS_AS(ui::ParseOutputFormat("json"sv), std::invalid_argument);
+
+    std::ostringstream stream;
+    ui::OutputBuffer output{stream};
+    ui::RecordWriter writer{output, ui::OutputFormat::Csv, std::span{BOOK_COLUMNS}.first(1)};
+    writer.Field(1);
+    CHECK_THROWS_AS(writer.Field(2), std::logic_error);
+}
+
+TEST_CASE("Book listing export throughput", "[.][benchmark]") {
+    constexpr int ROWS = 1'000'000;
+    const auto path = std::filesystem::temp_directory_path() / "bookypedia_export_benchmark.txt";
+
+    for (const auto& run : {std::pair{"JSON Lines", ui::OutputFormat::JsonLines},
+                            std::pair{"CSV", ui::OutputFormat::Csv}, std::pair{"TSV", ui::OutputFormat::Tsv}}) {
+        BENCHMARK(run.first) {
+            std::ofstream file{path};
+            ui::OutputBuffer output{file};
+            ui::RecordWriter writer{output, run.second, BOOK_COLUMNS};
+            for (int i = 1; i <= ROWS; ++i)
+                writer.Field(i).Field("War and Peace"sv).Field("Leo Tolstoy"sv).Field(1869).EndRecord();
+            output.Flush();
+            return file.tellp();
+        };
+    }
+    std::filesystem::remove(path);
+}
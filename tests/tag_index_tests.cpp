@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "../src/app/tag_index.h"
+#include "../src/util/bitmap.h"
+
+namespace {
+
+std::vector<uint32_t> ToVector(const std::set<uint32_t>& values) {
+    return {values.begin(), values.end()};
+}
+
+// Ids have no ordering, so sets are compared by their text form
+std::set<std::string> ToSet(const std::vector<domain::BookId>& ids) {
+    std::set<std::string> result;
+    for (const auto& id: ids)
+        result.insert(id.ToString());
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("Bitmap set operations agree with std::set") {
+    std::mt19937 random{42};
+    // Sparse and dense containers, and values spread over many containers
+    for (uint32_t range: {70'000u, 300'000u, 10'000'000u}) {
+        util::Bitmap left, right;
+        std::set<uint32_t> left_values, right_values;
+        for (int i = 0; i < 20'000; ++i) {
+            auto value = random() % range;
+            left.Add(value);
+            left_values.insert(value);
+            value = random() % range;
+            right.Add(value);
+            right_values.insert(value);
+        }
+        for (int i = 0; i < 5'000; ++i) {
+            auto value = random() % range;
+            left.Remove(value);
+            left_values.erase(value);
+        }
+        REQUIRE(left.ToVector() == ToVector(left_values));
+        CHECK(left.Cardinality() == left_values.size());
+        for (auto value: right_values)
+            CHECK(right.Contains(value) == true);
+
+        std::set<uint32_t> expected;
+        auto result = left;
+        result &= right;
+        std::set_intersection(left_values.begin(), left_values.end(), right_values.begin(), right_values.end(),
+                              std::inserter(expected, expected.end()));
+        CHECK(result.ToVector() == ToVector(expected));
+
+        expected.clear();
+        result = left;
+        result |= right;
+        std::set_union(left_values.begin(), left_values.end(), right_values.begin(), right_values.end(),
+                       std::inserter(expected, expected.end()));
+        CHECK(result.ToVector() == ToVector(expected));
+        CHECK(result.Cardinality() == expected.size());
+
+        expected.clear();
+        result = left;
+        result -= right;
+        std::set_difference(left_values.begin(), left_values.end(), right_values.begin(), right_values.end(),
+                            std::inserter(expected, expected.end()));
+        CHECK(result.ToVector() == ToVector(expected));
+
+        for (auto value: left_values)
+            left.Remove(value);
+        CHECK(left.Empty());
+    }
+}
+
+TEST_CASE("Tag index answers boolean tag queries") {
+    app::TagIndex index;
+    auto dune = domain::BookId::New();
+    auto solaris = domain::BookId::New();
+    auto emma = domain::BookId::New();
+    index.AddTags(dune, {"sci-fi", "classic", "desert"});
+    index.AddTags(solaris, {"sci-fi", "classic"});
+    index.AddTags(emma, {"classic", "romance"});
+
+    CHECK(ToSet(index.Find({{"sci-fi", "classic"}, {}, {}})) == ToSet({dune, solaris}));
+    CHECK(ToSet(index.Find({{"classic"}, {}, {"desert"}})) == ToSet({solaris, emma}));
+    CHECK(ToSet(index.Find({{}, {"romance", "desert"}, {}})) == ToSet({dune, emma}));
+    CHECK(ToSet(index.Find({{"classic"}, {"romance", "desert"}, {"sci-fi"}})) == ToSet({emma}));
+    CHECK(ToSet(index.Find({{}, {}, {"sci-fi"}})) == ToSet({emma}));
+    CHECK(index.Find({{"classic", "unknown"}, {}, {}}).empty());
+    CHECK(index.BookCount() == 3);
+    CHECK(index.TagCount() == 4);
+
+    index.SetTags(dune, {"desert"});
+    CHECK(ToSet(index.Find({{"sci-fi"}, {}, {}})) == ToSet({solaris}));
+
+    index.RemoveBook(solaris);
+    CHECK(index.Find({{"sci-fi"}, {}, {}}).empty());
+    CHECK(index.BookCount() == 2);
+
+    // The freed ordinal is reused without leaking the removed book's tags
+    auto solaris_again = domain::BookId::New();
+    index.AddTags(solaris_again, {"space"});
+    CHECK(ToSet(index.Find({{"space"}, {}, {}})) == ToSet({solaris_again}));
+    CHECK(index.Find({{"classic"}, {"space"}, {}}).empty());
+
+    index.SetTags(emma, {});
+    CHECK(ToSet(index.Find({})) == ToSet({dune, solaris_again}));
+}
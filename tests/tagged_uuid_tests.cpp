@@ -1,5 +1,14 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/string_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
 #include "../src/util/tagged_uuid.h"
 
 using util::TaggedUUID;
@@ -13,4 +22,106 @@ TEST_CASE("UUID-String conversion") {
     auto uuid = TestUUID::New();
     auto s = uuid.ToString();
     CHECK(TestUUID::FromString(s) == uuid);
-}
\ No newline at end of file
+}
+TEST_CASE("UUID is formatted in canonical form") {
+    auto uuid = TestUUID::FromString("0123abcd-4567-89ef-0123-456789ABCDEF");
+    char buf[util::detail::UUID_TEXT_SIZE];
+    auto end = util::detail::UUIDToChars(*uuid, buf);
+    CHECK(std::string_view(buf, end - buf) == "0123abcd-4567-89ef-0123-456789abcdef");
+    CHECK(uuid.ToString() == "0123abcd-4567-89ef-0123-456789abcdef");
+}
+
+TEST_CASE("Time-ordered UUIDs increase and carry version 7") {
+    util::SetUUIDVersion(util::UUIDVersion::TimeOrdered);
+    auto prev = TestUUID::New();
+    for (int i = 0; i < 10000; ++i) {
+        auto next = TestUUID::New();
+        // Boost predates version 7, so the version nibble is read directly
+        CHECK(((*next).data[6] >> 4) == 7);
+        CHECK((*next).variant() == boost::uuids::uuid::variant_rfc_4122);
+        CHECK(*prev < *next);
+        prev = next;
+    }
+    util::SetUUIDVersion(util::UUIDVersion::Random);
+    CHECK((*TestUUID::New()).version() == boost::uuids::uuid::version_random_number_based);
+}
+
+TEST_CASE("UUID parsing and formatting agree with Boost") {
+    boost::uuids::random_generator generator;
+    for (int i = 0; i < 1000; ++i) {
+        auto uuid = generator();
+        auto text = boost::uuids::to_string(uuid);
+        CHECK(util::detail::UUIDToString(uuid) == text);
+        CHECK(util::detail::UUIDFromString(text) == uuid);
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+            return static_cast<char>(std::toupper(c));
+        });
+        CHECK(util::detail::UUIDFromString(text) == uuid);
+    }
+}
+
+TEST_CASE("Malformed UUIDs are rejected") {
+    const std::string valid = "0123abcd-4567-89ef-0123-456789abcdef";
+    REQUIRE(TestUUID::TryFromString(valid).has_value());
+    CHECK_FALSE(TestUUID::TryFromString("").has_value());
+    CHECK_FALSE(TestUUID::TryFromString(valid.substr(1)).has_value());
+    CHECK_FALSE(TestUUID::TryFromString("{" + valid + "}").has_value());
+    CHECK_FALSE(TestUUID::TryFromString("0123abcd045670089ef001230456789abcdef").has_value());
+    CHECK_THROWS_AS(TestUUID::FromString("not a uuid"), std::invalid_argument);
+
+    // Every non-hex byte must be caught wherever a digit is expected
+    for (size_t pos: {0, 7, 9, 19, 35}) {
+        for (int c = 0; c < 256; ++c) {
+            auto text = valid;
+            text[pos] = static_cast<char>(c);
+            CHECK(TestUUID::TryFromString(text).has_value() == (std::isxdigit(c) != 0));
+        }
+    }
+}
+
+TEST_CASE("UUID conversion throughput", "[.][benchmark]") {
+    boost::uuids::random_generator generator;
+    // The generator is not copyable, so std::generate cannot take it by value
+    std::vector<boost::uuids::uuid> uuids(1000);
+    std::generate(uuids.begin(), uuids.end(), [&generator] {
+        return generator();
+    });
+    std::vector<std::string> texts;
+    for (const auto& uuid: uuids)
+        texts.push_back(boost::uuids::to_string(uuid));
+
+    BENCHMARK("Parse, Boost string_generator") {
+        boost::uuids::string_generator parse;
+        size_t sum = 0;
+        for (const auto& text: texts)
+            sum += parse(text).data[0];
+        return sum;
+    };
+    BENCHMARK("Parse, TryUUIDFromString") {
+        size_t sum = 0;
+        for (const auto& text: texts)
+            sum += util::detail::TryUUIDFromString(text)->data[0];
+        return sum;
+    };
+    BENCHMARK("Format, Boost to_string") {
+        size_t sum = 0;
+        for (const auto& uuid: uuids)
+            sum += boost::uuids::to_string(uuid)[0];
+        return sum;
+    };
+    BENCHMARK("Format, UUIDToString") {
+        size_t sum = 0;
+        for (const auto& uuid: uuids)
+            sum += util::detail::UUIDToString(uuid)[0];
+        return sum;
+    };
+    BENCHMARK("Format, UUIDToChars") {
+        char buf[util::detail::UUID_TEXT_SIZE];
+        size_t sum = 0;
+        for (const auto& uuid: uuids) {
+            util::detail::UUIDToChars(uuid, buf);
+            sum += buf[0];
+        }
+        return sum;
+    };
+}